@@ -4,14 +4,24 @@
 
 #include <benchmark/benchmark.h>
 
+#include <cstdio>
 #include <fstream>
+#include <map>
+#include <string>
 
 #include "bm_baseline.hpp"
+#include "bm_file.hpp"
+#include "bm_keywords.hpp"
+#include "bm_long_literals.hpp"
+#include "bm_line_index.hpp"
 #include "bm_manual.hpp"
 #include "bm_manual_opt.hpp"
+#include "bm_token_kind.hpp"
 #include "bm_tokenizer.hpp"
 #include "bm_tokenizer_manual.hpp"
+#include "bm_tokenizer_wide.hpp"
 #include "bm_trie.hpp"
+#include "bm_trie_table.hpp"
 
 namespace lex = foonathan::lex;
 
@@ -20,8 +30,13 @@ namespace
 char       all_error[32 * 1024];
 char       all_last[32 * 1024];
 char       all_first[32 * 1024];
+char       all_late_root[32 * 1024];
+char       indented[32 * 1024];
+char       identifiers[32 * 1024];
 const char punctuation[]    = "....+=+++->*->---=-~";
 const char punctuation_ws[] = "...  .  +=  ++  +  ->*  ->  --  -=  -  ~";
+const char c_punctuation[]
+    = "(){}[]+-*/%&^|>><<++--=+=-=*=/=%=&=^=|=>>=<<===!=<><=>=&&||;,:....->!?~";
 
 auto init = []() noexcept
 {
@@ -31,6 +46,47 @@ auto init = []() noexcept
         c = '~';
     for (auto& c : all_first)
         c = '.';
+    for (auto& c : all_late_root)
+        c = '~';
+
+    // lines of punctuation, indented like source code
+    const char* lines[] = {"+= ... ->* ~", "-- -> + -", "...", "++ - -= . ~~", ""};
+    const int   depth[] = {1, 2, 3, 4, 3, 2, 4, 1, 0, 1};
+    auto        pos     = 0u;
+    auto        put     = [&](char c) {
+        if (pos < sizeof(indented) - 1)
+            indented[pos++] = c;
+    };
+    for (auto i = 0u; pos < sizeof(indented) - 1; ++i)
+    {
+        auto line = lines[i % 5];
+        if (*line)
+            for (auto j = 0; j != 4 * depth[i % 10]; ++j)
+                put(' ');
+        for (; *line; ++line)
+            put(*line);
+        put('\n');
+    }
+
+    // ASCII identifiers of different lengths, separated by whitespace
+    const char* words[] = {"i", "index", "_tmp", "value2", "get_next_token", "x", "buffer_size",
+                           "LexerState", "n"};
+    pos = 0u;
+    for (auto i = 0u; pos < sizeof(identifiers) - 1; ++i)
+    {
+        for (auto word = words[i % 9]; *word && pos < sizeof(identifiers) - 1; ++word)
+            identifiers[pos++] = *word;
+        if (pos < sizeof(identifiers) - 1)
+            identifiers[pos++] = i % 7 == 6 ? '\n' : ' ';
+    }
+
+    // the last character isn't part of the input, but the null terminator
+    all_error[sizeof(all_error) - 1]         = '\0';
+    all_last[sizeof(all_last) - 1]           = '\0';
+    all_first[sizeof(all_first) - 1]         = '\0';
+    all_late_root[sizeof(all_late_root) - 1] = '\0';
+    indented[sizeof(indented) - 1]           = '\0';
+    identifiers[sizeof(identifiers) - 1]     = '\0';
     return 0;
 }
 ();
@@ -94,6 +150,7 @@ BENCHMARK_CAPTURE(bm_3_manual_opt, all_last, all_last);
 BENCHMARK_CAPTURE(bm_3_manual_opt, all_first, all_first);
 BENCHMARK_CAPTURE(bm_3_manual_opt, punctuation, punctuation);
 BENCHMARK_CAPTURE(bm_3_manual_opt, punctuation_ws, punctuation_ws);
+BENCHMARK_CAPTURE(bm_3_manual_opt, indented, indented);
 
 template <unsigned N>
 void bm_4_trie(benchmark::State& state, const char (&array)[N])
@@ -116,6 +173,205 @@ BENCHMARK_CAPTURE(bm_5_tokenizer, all_last, all_last);
 BENCHMARK_CAPTURE(bm_5_tokenizer, all_first, all_first);
 BENCHMARK_CAPTURE(bm_5_tokenizer, punctuation, punctuation);
 BENCHMARK_CAPTURE(bm_5_tokenizer, punctuation_ws, punctuation_ws);
+BENCHMARK_CAPTURE(bm_5_tokenizer, indented, indented);
+
+template <unsigned N>
+void bm_5_tokenizer_range(benchmark::State& state, const char (&array)[N])
+{
+    benchmark_impl(&tokenizer_range, state, array, array + N - 1);
+}
+BENCHMARK_CAPTURE(bm_5_tokenizer_range, all_error, all_error);
+BENCHMARK_CAPTURE(bm_5_tokenizer_range, all_last, all_last);
+BENCHMARK_CAPTURE(bm_5_tokenizer_range, all_first, all_first);
+BENCHMARK_CAPTURE(bm_5_tokenizer_range, punctuation, punctuation);
+BENCHMARK_CAPTURE(bm_5_tokenizer_range, punctuation_ws, punctuation_ws);
+BENCHMARK_CAPTURE(bm_5_tokenizer_range, indented, indented);
+
+#if FOONATHAN_LEX_HAS_COROUTINES
+template <unsigned N>
+void bm_5_tokenizer_generator(benchmark::State& state, const char (&array)[N])
+{
+    benchmark_impl(&tokenizer_generator, state, array, array + N - 1);
+}
+BENCHMARK_CAPTURE(bm_5_tokenizer_generator, all_error, all_error);
+BENCHMARK_CAPTURE(bm_5_tokenizer_generator, all_last, all_last);
+BENCHMARK_CAPTURE(bm_5_tokenizer_generator, all_first, all_first);
+BENCHMARK_CAPTURE(bm_5_tokenizer_generator, punctuation, punctuation);
+BENCHMARK_CAPTURE(bm_5_tokenizer_generator, punctuation_ws, punctuation_ws);
+BENCHMARK_CAPTURE(bm_5_tokenizer_generator, indented, indented);
+#endif
+
+template <unsigned N>
+void bm_5_tokenizer_buffer(benchmark::State& state, const char (&array)[N])
+{
+    benchmark_impl(&tokenizer_buffer, state, array, array + N - 1);
+}
+BENCHMARK_CAPTURE(bm_5_tokenizer_buffer, all_error, all_error);
+BENCHMARK_CAPTURE(bm_5_tokenizer_buffer, all_last, all_last);
+BENCHMARK_CAPTURE(bm_5_tokenizer_buffer, all_first, all_first);
+BENCHMARK_CAPTURE(bm_5_tokenizer_buffer, punctuation, punctuation);
+BENCHMARK_CAPTURE(bm_5_tokenizer_buffer, punctuation_ws, punctuation_ws);
+
+template <unsigned N>
+void bm_5_tokenizer_coalesce(benchmark::State& state, const char (&array)[N])
+{
+    benchmark_impl(&tokenizer_coalesce, state, array, array + N - 1);
+}
+BENCHMARK_CAPTURE(bm_5_tokenizer_coalesce, all_error, all_error);
+BENCHMARK_CAPTURE(bm_5_tokenizer_coalesce, all_last, all_last);
+BENCHMARK_CAPTURE(bm_5_tokenizer_coalesce, all_first, all_first);
+BENCHMARK_CAPTURE(bm_5_tokenizer_coalesce, punctuation, punctuation);
+BENCHMARK_CAPTURE(bm_5_tokenizer_coalesce, punctuation_ws, punctuation_ws);
+
+template <unsigned N>
+void bm_5_tokenizer_null_terminated(benchmark::State& state, const char (&array)[N])
+{
+    benchmark_impl(&tokenizer_null_terminated, state, array, array + N - 1);
+}
+BENCHMARK_CAPTURE(bm_5_tokenizer_null_terminated, all_error, all_error);
+BENCHMARK_CAPTURE(bm_5_tokenizer_null_terminated, all_last, all_last);
+BENCHMARK_CAPTURE(bm_5_tokenizer_null_terminated, all_first, all_first);
+BENCHMARK_CAPTURE(bm_5_tokenizer_null_terminated, punctuation, punctuation);
+BENCHMARK_CAPTURE(bm_5_tokenizer_null_terminated, punctuation_ws, punctuation_ws);
+BENCHMARK_CAPTURE(bm_5_tokenizer_null_terminated, indented, indented);
+
+template <unsigned N>
+void bm_5_tokenizer_wide(benchmark::State& state, const char (&array)[N])
+{
+    benchmark_impl(&tokenizer_wide, state, array, array + N - 1);
+}
+BENCHMARK_CAPTURE(bm_5_tokenizer_wide, all_error, all_error);
+BENCHMARK_CAPTURE(bm_5_tokenizer_wide, all_late_root, all_late_root);
+BENCHMARK_CAPTURE(bm_5_tokenizer_wide, c_punctuation, c_punctuation);
+
+template <unsigned N>
+void bm_5_tokenizer_ascii_identifier(benchmark::State& state, const char (&array)[N])
+{
+    benchmark_impl(&tokenizer_identifier<tokenizer_ns::ascii_identifier_spec>, state, array,
+                   array + N - 1);
+}
+BENCHMARK_CAPTURE(bm_5_tokenizer_ascii_identifier, identifiers, identifiers);
+
+template <unsigned N>
+void bm_5_tokenizer_unicode_identifier(benchmark::State& state, const char (&array)[N])
+{
+    benchmark_impl(&tokenizer_identifier<tokenizer_ns::unicode_identifier_spec>, state, array,
+                   array + N - 1);
+}
+BENCHMARK_CAPTURE(bm_5_tokenizer_unicode_identifier, identifiers, identifiers);
+
+template <class TokenSpec>
+void bm_6_token_kind(benchmark::State& state, TokenSpec)
+{
+    auto kinds = token_kind_ns::make_kinds<TokenSpec>(4 * 1024);
+    for (auto _ : state)
+        token_kind(kinds, [](const char* name) { benchmark::DoNotOptimize(name); });
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations())
+                            * static_cast<std::int64_t>(kinds.size()));
+}
+BENCHMARK_CAPTURE(bm_6_token_kind, tokens_8, token_kind_ns::token_spec<8>{});
+BENCHMARK_CAPTURE(bm_6_token_kind, tokens_64, token_kind_ns::token_spec<64>{});
+BENCHMARK_CAPTURE(bm_6_token_kind, tokens_512, token_kind_ns::token_spec<512>{});
+
+void bm_7_file(benchmark::State& state,
+               void (*f)(const char*, void (*)(int, lex::token_spelling)))
+{
+    constexpr auto file_size = 16 * 1024 * 1024u;
+    file_ns::write_file(indented, indented + sizeof(indented) - 1, file_size);
+    for (auto _ : state)
+    {
+        f(file_ns::path, [](int kind, lex::token_spelling spelling) {
+            benchmark::DoNotOptimize(kind);
+            benchmark::DoNotOptimize(spelling.data());
+            benchmark::DoNotOptimize(spelling.size());
+        });
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+                            * static_cast<std::int64_t>(file_size));
+    std::remove(file_ns::path);
+}
+BENCHMARK_CAPTURE(bm_7_file, read, &file_read);
+BENCHMARK_CAPTURE(bm_7_file, mapped, &file_mapped);
+
+void bm_8_tokenizer_parallel(benchmark::State& state, unsigned thread_count)
+{
+    static const auto input = [] {
+        std::string result;
+        while (result.size() < 16 * 1024 * 1024u)
+            result.append(indented, sizeof(indented) - 1);
+        return result;
+    }();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(
+            tokenizer_parallel(input.data(), input.data() + input.size(), thread_count));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+                            * static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK_CAPTURE(bm_8_tokenizer_parallel, threads_1, 1u)->UseRealTime();
+BENCHMARK_CAPTURE(bm_8_tokenizer_parallel, threads_2, 2u)->UseRealTime();
+BENCHMARK_CAPTURE(bm_8_tokenizer_parallel, threads_4, 4u)->UseRealTime();
+BENCHMARK_CAPTURE(bm_8_tokenizer_parallel, threads_8, 8u)->UseRealTime();
+
+void bm_9_line_index(benchmark::State& state, std::size_t (*f)(const char*, const char*))
+{
+    static const auto input = [] {
+        std::string result;
+        while (result.size() < 16 * 1024 * 1024u)
+            result.append(indented, sizeof(indented) - 1);
+        return result;
+    }();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(f(input.data(), input.data() + input.size()));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+                            * static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK_CAPTURE(bm_9_line_index, naive, &line_index_naive);
+BENCHMARK_CAPTURE(bm_9_line_index, index, &line_index);
+
+template <std::size_t N, bool Flat>
+void bm_10_trie_impl(benchmark::State& state)
+{
+    using spec        = trie_table_ns::token_spec<N, Flat>;
+    static auto input = trie_table_ns::make_input<spec>(32 * 1024);
+    benchmark_impl(&trie_table<spec>, state, input.data(), input.data() + input.size());
+}
+
+template <std::size_t N>
+void bm_10_trie_template(benchmark::State& state, std::integral_constant<std::size_t, N>)
+{
+    bm_10_trie_impl<N, false>(state);
+}
+BENCHMARK_CAPTURE(bm_10_trie_template, literals_16, std::integral_constant<std::size_t, 16>{});
+BENCHMARK_CAPTURE(bm_10_trie_template, literals_64, std::integral_constant<std::size_t, 64>{});
+BENCHMARK_CAPTURE(bm_10_trie_template, literals_256, std::integral_constant<std::size_t, 256>{});
+
+template <std::size_t N>
+void bm_10_trie_table(benchmark::State& state, std::integral_constant<std::size_t, N>)
+{
+    bm_10_trie_impl<N, true>(state);
+}
+BENCHMARK_CAPTURE(bm_10_trie_table, literals_16, std::integral_constant<std::size_t, 16>{});
+BENCHMARK_CAPTURE(bm_10_trie_table, literals_64, std::integral_constant<std::size_t, 64>{});
+BENCHMARK_CAPTURE(bm_10_trie_table, literals_256, std::integral_constant<std::size_t, 256>{});
+
+void bm_11_keywords(benchmark::State& state, unsigned keyword_percentage)
+{
+    auto input = keywords_ns::make_input(32 * 1024, keyword_percentage);
+    benchmark_impl(&keywords, state, input.data(), input.data() + input.size());
+}
+BENCHMARK_CAPTURE(bm_11_keywords, keywords_0, 0u);
+BENCHMARK_CAPTURE(bm_11_keywords, keywords_50, 50u);
+BENCHMARK_CAPTURE(bm_11_keywords, keywords_100, 100u);
+
+void bm_12_long_literals(benchmark::State& state, bool whitespace)
+{
+    auto input = long_literals_ns::make_input(32 * 1024, whitespace);
+    benchmark_impl(&long_literals, state, input.data(), input.data() + input.size());
+}
+BENCHMARK_CAPTURE(bm_12_long_literals, no_whitespace, false);
+BENCHMARK_CAPTURE(bm_12_long_literals, whitespace, true);
 
 int main(int argc, char* argv[])
 {
@@ -139,7 +395,13 @@ int main(int argc, char* argv[])
                     categories_.push_back(name.second);
 
                 // insert the data
-                result_[name.first].push_back(run.counters.at("bytes_per_second"));
+                auto bytes = run.counters.find("bytes_per_second");
+                if (bytes != run.counters.end())
+                    result_[name.first][name.second]
+                        = format_result(bytes->second / (1024 * 1024), " MiB/s");
+                else
+                    result_[name.first][name.second]
+                        = format_result(run.counters.at("items_per_second") / 1000000, " M/s");
             }
         }
 
@@ -166,10 +428,12 @@ td {
             {
                 out << "<tr>";
                 out << "<th>" << pair.first << "</th>";
-                for (auto& result : pair.second)
+                for (auto& cat : categories_)
                 {
                     out << "<td>";
-                    print_result(out, result);
+                    auto result = pair.second.find(cat);
+                    if (result != pair.second.end())
+                        out << result->second;
                     out << "</td>";
                 }
                 out << "</tr>\n";
@@ -190,13 +454,13 @@ td {
             return std::make_pair(name, data);
         }
 
-        static void print_result(std::ostream& out, double result)
+        static std::string format_result(double result, const char* unit)
         {
-            out << static_cast<std::uint64_t>(result / (1024 * 1024)) << " MiB/s";
+            return std::to_string(static_cast<std::uint64_t>(result)) + unit;
         }
 
-        std::vector<std::string>                   categories_;
-        std::map<std::string, std::vector<double>> result_;
+        std::vector<std::string>                                   categories_;
+        std::map<std::string, std::map<std::string, std::string>> result_;
     } reporter;
 
     // need to specify an output file for custom file reporters
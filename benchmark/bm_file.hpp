@@ -0,0 +1,46 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_BM_FILE_HPP_INCLUDED
+#define FOONATHAN_LEX_BM_FILE_HPP_INCLUDED
+
+#include <fstream>
+#include <string>
+
+#include <foonathan/lex/mapped_input.hpp>
+
+#include "bm_tokenizer.hpp"
+
+namespace file_ns
+{
+const char path[] = "foonathan_lex_benchmark_input.txt";
+
+// writes the input repeatedly until the file has the given size
+inline void write_file(const char* str, const char* end, std::size_t file_size)
+{
+    std::ofstream file(path, std::ios::binary);
+    for (auto size = std::size_t(0); size < file_size; size += std::size_t(end - str))
+        file.write(str, end - str);
+}
+} // namespace file_ns
+
+void file_read(const char* path, void (*f)(int, foonathan::lex::token_spelling))
+{
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(0, std::ios::end);
+    std::string buffer(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+
+    // the string is null terminated as well
+    tokenizer_null_terminated(buffer.data(), buffer.data() + buffer.size(), f);
+}
+
+void file_mapped(const char* path, void (*f)(int, foonathan::lex::token_spelling))
+{
+    foonathan::lex::mapped_input input(path);
+    tokenizer_null_terminated(input.begin(), input.end(), f);
+}
+
+#endif // FOONATHAN_LEX_BM_FILE_HPP_INCLUDED
@@ -0,0 +1,131 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_BM_KEYWORDS_HPP_INCLUDED
+#define FOONATHAN_LEX_BM_KEYWORDS_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace keywords_ns
+{
+namespace lex = foonathan::lex;
+
+using token_spec
+    = lex::token_spec<struct identifier, struct whitespace, struct k_auto, struct k_break,
+                      struct k_case, struct k_char, struct k_const, struct k_continue,
+                      struct k_default, struct k_do, struct k_double, struct k_else, struct k_enum,
+                      struct k_extern, struct k_float, struct k_for, struct k_goto, struct k_if,
+                      struct k_int, struct k_long, struct k_register, struct k_return,
+                      struct k_short, struct k_signed, struct k_sizeof, struct k_static,
+                      struct k_struct, struct k_switch, struct k_typedef, struct k_union,
+                      struct k_unsigned, struct k_void, struct k_volatile, struct k_while>;
+
+struct identifier : lex::identifier_token<identifier, token_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        namespace tr = lex::token_rule;
+        return (tr::r('_') / lex::ascii::is_alpha) + tr::star(tr::r('_') / lex::ascii::is_alnum);
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, token_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+#define FOONATHAN_LEX_BM_KEYWORD(Name)                                                             \
+    struct k_##Name : FOONATHAN_LEX_KEYWORD(#Name)                                                 \
+    {};
+
+FOONATHAN_LEX_BM_KEYWORD(auto)
+FOONATHAN_LEX_BM_KEYWORD(break)
+FOONATHAN_LEX_BM_KEYWORD(case)
+FOONATHAN_LEX_BM_KEYWORD(char)
+FOONATHAN_LEX_BM_KEYWORD(const)
+FOONATHAN_LEX_BM_KEYWORD(continue)
+FOONATHAN_LEX_BM_KEYWORD(default)
+FOONATHAN_LEX_BM_KEYWORD(do)
+FOONATHAN_LEX_BM_KEYWORD(double)
+FOONATHAN_LEX_BM_KEYWORD(else)
+FOONATHAN_LEX_BM_KEYWORD(enum)
+FOONATHAN_LEX_BM_KEYWORD(extern)
+FOONATHAN_LEX_BM_KEYWORD(float)
+FOONATHAN_LEX_BM_KEYWORD(for)
+FOONATHAN_LEX_BM_KEYWORD(goto)
+FOONATHAN_LEX_BM_KEYWORD(if)
+FOONATHAN_LEX_BM_KEYWORD(int)
+FOONATHAN_LEX_BM_KEYWORD(long)
+FOONATHAN_LEX_BM_KEYWORD(register)
+FOONATHAN_LEX_BM_KEYWORD(return)
+FOONATHAN_LEX_BM_KEYWORD(short)
+FOONATHAN_LEX_BM_KEYWORD(signed)
+FOONATHAN_LEX_BM_KEYWORD(sizeof)
+FOONATHAN_LEX_BM_KEYWORD(static)
+FOONATHAN_LEX_BM_KEYWORD(struct)
+FOONATHAN_LEX_BM_KEYWORD(switch)
+FOONATHAN_LEX_BM_KEYWORD(typedef)
+FOONATHAN_LEX_BM_KEYWORD(union)
+FOONATHAN_LEX_BM_KEYWORD(unsigned)
+FOONATHAN_LEX_BM_KEYWORD(void)
+FOONATHAN_LEX_BM_KEYWORD(volatile)
+FOONATHAN_LEX_BM_KEYWORD(while)
+
+#undef FOONATHAN_LEX_BM_KEYWORD
+
+// a pseudo-random sequence of words separated by spaces,
+// the given percentage of them are keywords, the others identifiers that are similar to keywords
+std::string make_input(std::size_t size, unsigned keyword_percentage)
+{
+    const char* keywords[]    = {"auto",   "break",  "case",     "char",   "const",    "continue",
+                              "default", "do",     "double",   "else",   "enum",     "extern",
+                              "float",   "for",    "goto",     "if",     "int",      "long",
+                              "register", "return", "short",    "signed", "sizeof",   "static",
+                              "struct",  "switch", "typedef",  "union",  "unsigned", "void",
+                              "volatile", "while"};
+    const char* identifiers[] = {"i",       "x",         "count",    "index",   "integer",
+                                 "counter", "constant",  "returned", "structs", "do_it",
+                                 "buffer",  "size",      "value",    "result",  "in",
+                                 "whilst"};
+
+    std::string result;
+    result.reserve(size);
+
+    std::uint32_t state = 42;
+    while (result.size() < size)
+    {
+        state = state * 1664525u + 1013904223u;
+        if ((state >> 16) % 100 < keyword_percentage)
+            result += keywords[(state >> 8) % 32];
+        else
+            result += identifiers[(state >> 8) % 16];
+        result += ' ';
+    }
+    return result;
+}
+} // namespace keywords_ns
+
+void keywords(const char* str, const char* end, void (*f)(int, foonathan::lex::token_spelling))
+{
+    using namespace keywords_ns;
+    namespace lex = foonathan::lex;
+
+    lex::tokenizer<token_spec> tokenizer(str, end);
+    while (!tokenizer.is_done())
+    {
+        auto cur = tokenizer.peek();
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+        tokenizer.bump();
+    }
+}
+
+#endif // FOONATHAN_LEX_BM_KEYWORDS_HPP_INCLUDED
@@ -0,0 +1,34 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_BM_LINE_INDEX_HPP_INCLUDED
+#define FOONATHAN_LEX_BM_LINE_INDEX_HPP_INCLUDED
+
+#include <foonathan/lex/line_index.hpp>
+
+// line and column of the end, by scanning the entire input
+std::size_t line_index_naive(const char* str, const char* end)
+{
+    auto line   = std::size_t(1);
+    auto column = std::size_t(1);
+    for (; str != end; ++str)
+        if (*str == '\n' || (*str == '\r' && (str + 1 == end || str[1] != '\n')))
+        {
+            ++line;
+            column = 1;
+        }
+        else
+            ++column;
+    return line + column;
+}
+
+// line and column of the end, by building the index
+std::size_t line_index(const char* str, const char* end)
+{
+    foonathan::lex::line_index index(str, end);
+    auto                       result = index.location(end);
+    return result.line + result.column;
+}
+
+#endif // FOONATHAN_LEX_BM_LINE_INDEX_HPP_INCLUDED
@@ -0,0 +1,108 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_BM_LONG_LITERALS_HPP_INCLUDED
+#define FOONATHAN_LEX_BM_LONG_LITERALS_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace long_literals_ns
+{
+namespace lex = foonathan::lex;
+
+using token_spec
+    = lex::token_spec<struct static_assert_, struct attribute, struct thread_local_,
+                      struct reinterpret_cast_, struct dynamic_cast_, struct const_cast_,
+                      struct static_cast_, struct noexcept_spec, struct alignas_value,
+                      struct constexpr_if, struct namespace_alias, struct template_param,
+                      struct decltype_auto, struct typename_outer, struct protected_base,
+                      struct virtual_override, struct whitespace>;
+
+// long literals that share at most a short prefix,
+// so most of their characters are in chains of nodes with a single child
+struct static_assert_ : FOONATHAN_LEX_LITERAL("static_assert")
+{};
+struct attribute : FOONATHAN_LEX_LITERAL("__attribute__")
+{};
+struct thread_local_ : FOONATHAN_LEX_LITERAL("thread_local")
+{};
+struct reinterpret_cast_ : FOONATHAN_LEX_LITERAL("reinterpret_cast")
+{};
+struct dynamic_cast_ : FOONATHAN_LEX_LITERAL("dynamic_cast")
+{};
+struct const_cast_ : FOONATHAN_LEX_LITERAL("const_cast")
+{};
+struct static_cast_ : FOONATHAN_LEX_LITERAL("static_cast")
+{};
+struct noexcept_spec : FOONATHAN_LEX_LITERAL("noexcept_spec")
+{};
+struct alignas_value : FOONATHAN_LEX_LITERAL("alignas_value")
+{};
+struct constexpr_if : FOONATHAN_LEX_LITERAL("constexpr_if")
+{};
+struct namespace_alias : FOONATHAN_LEX_LITERAL("namespace_alias")
+{};
+struct template_param : FOONATHAN_LEX_LITERAL("template_param")
+{};
+struct decltype_auto : FOONATHAN_LEX_LITERAL("decltype_auto")
+{};
+struct typename_outer : FOONATHAN_LEX_LITERAL("typename_outer")
+{};
+struct protected_base : FOONATHAN_LEX_LITERAL("protected_base")
+{};
+struct virtual_override : FOONATHAN_LEX_LITERAL("virtual_override")
+{};
+
+struct whitespace : lex::rule_token<whitespace, token_spec>, lex::whitespace_token
+{
+    static constexpr const char* name = "<whitespace>";
+
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+// a pseudo-random sequence of the literals, optionally separated by spaces
+std::string make_input(std::size_t size, bool whitespace)
+{
+    // the literals have the ids 1 to 16
+    constexpr auto count = 16u;
+
+    std::string result;
+    result.reserve(size);
+
+    std::uint32_t state = 42;
+    while (result.size() < size)
+    {
+        state = state * 1664525u + 1013904223u;
+        result += lex::token_kind<token_spec>::from_id((state >> 16) % count + 1).name();
+        if (whitespace)
+            result += ' ';
+    }
+    return result;
+}
+} // namespace long_literals_ns
+
+void long_literals(const char* str, const char* end,
+                   void (*f)(int, foonathan::lex::token_spelling))
+{
+    using namespace long_literals_ns;
+    namespace lex = foonathan::lex;
+
+    lex::tokenizer<token_spec> tokenizer(str, end);
+    while (!tokenizer.is_done())
+    {
+        auto cur = tokenizer.peek();
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+        tokenizer.bump();
+    }
+}
+
+#endif // FOONATHAN_LEX_BM_LONG_LITERALS_HPP_INCLUDED
@@ -0,0 +1,65 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_BM_TOKEN_KIND_HPP_INCLUDED
+#define FOONATHAN_LEX_BM_TOKEN_KIND_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/mp11/algorithm.hpp>
+
+#include <foonathan/lex/rule_token.hpp>
+#include <foonathan/lex/token_kind.hpp>
+#include <foonathan/lex/whitespace_token.hpp>
+
+namespace token_kind_ns
+{
+namespace lex = foonathan::lex;
+
+struct no_category
+{};
+
+// every fourth token is a whitespace token
+template <class I>
+struct numbered_token
+: lex::null_token, std::conditional_t<I::value % 4 == 0, lex::whitespace_token, no_category>
+{
+    static constexpr const char* name = "<numbered>";
+};
+
+template <std::size_t N>
+using token_spec = boost::mp11::mp_rename<
+    boost::mp11::mp_transform<numbered_token, boost::mp11::mp_iota_c<N>>, lex::token_spec>;
+
+// a pseudo-random sequence of token kinds
+template <class TokenSpec>
+std::vector<lex::token_kind<TokenSpec>> make_kinds(std::size_t count)
+{
+    constexpr auto size = boost::mp11::mp_size<typename TokenSpec::list>::value;
+
+    std::vector<lex::token_kind<TokenSpec>> result;
+    result.reserve(count);
+
+    std::uint32_t state = 42;
+    for (auto i = 0u; i != count; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        result.push_back(lex::token_kind<TokenSpec>::from_id((state >> 16) % size));
+    }
+    return result;
+}
+} // namespace token_kind_ns
+
+template <class TokenSpec, typename Func>
+void token_kind(const std::vector<foonathan::lex::token_kind<TokenSpec>>& kinds, Func f)
+{
+    for (auto kind : kinds)
+    {
+        if (!kind.template is_category<foonathan::lex::is_whitespace_token>())
+            f(kind.name());
+    }
+}
+
+#endif // FOONATHAN_LEX_BM_TOKEN_KIND_HPP_INCLUDED
@@ -6,7 +6,13 @@
 #define FOONATHAN_LEX_BM_TOKENIZER_HPP_INCLUDED
 
 #include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/identifier_token.hpp>
+#include <foonathan/lex/parallel_tokenize.hpp>
+#include <foonathan/lex/token_buffer.hpp>
+#include <foonathan/lex/token_generator.hpp>
+#include <foonathan/lex/token_range.hpp>
 #include <foonathan/lex/tokenizer.hpp>
+#include <foonathan/lex/unicode.hpp>
 
 namespace tokenizer_ns
 {
@@ -57,6 +63,84 @@ struct whitespace : lex::rule_token<whitespace, token_spec>
         return lex::token_rule::star(lex::ascii::is_space);
     }
 };
+
+// same tokens, but errors are coalesced
+struct coalescing_spec
+: lex::token_spec<ellipsis, dot, plus_eq, plus_plus, plus, arrow_deref, arrow, minus_minus,
+                  minus_eq, minus, tilde, struct coalescing_whitespace>
+{
+    static constexpr bool coalesce_errors = true;
+};
+
+struct coalescing_whitespace : lex::rule_token<coalescing_whitespace, coalescing_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::star(lex::ascii::is_space);
+    }
+};
+
+// same tokens, but the input is null terminated
+struct null_terminated_spec
+: lex::token_spec<ellipsis, dot, plus_eq, plus_plus, plus, arrow_deref, arrow, minus_minus,
+                  minus_eq, minus, tilde, struct null_terminated_whitespace>
+{
+    static constexpr bool null_terminated = true;
+};
+
+struct null_terminated_whitespace
+: lex::rule_token<null_terminated_whitespace, null_terminated_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::star(lex::ascii::is_space);
+    }
+};
+
+// identifiers using the `lex::ascii` predicates
+using ascii_identifier_spec
+    = lex::token_spec<struct ascii_identifier, struct ascii_identifier_whitespace>;
+
+struct ascii_identifier : lex::identifier_token<ascii_identifier, ascii_identifier_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        namespace tr = lex::token_rule;
+        return (tr::r('_') / lex::ascii::is_alpha) + tr::star(tr::r('_') / lex::ascii::is_alnum);
+    }
+};
+
+struct ascii_identifier_whitespace
+: lex::rule_token<ascii_identifier_whitespace, ascii_identifier_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::star(lex::ascii::is_space);
+    }
+};
+
+// identifiers following UAX #31
+using unicode_identifier_spec
+    = lex::token_spec<struct unicode_identifier, struct unicode_identifier_whitespace>;
+
+struct unicode_identifier : lex::identifier_token<unicode_identifier, unicode_identifier_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        namespace tr = lex::token_rule;
+        return (tr::r('_') / tr::code_point(lex::unicode::is_xid_start))
+               + tr::star(tr::code_point(lex::unicode::is_xid_continue));
+    }
+};
+
+struct unicode_identifier_whitespace
+: lex::rule_token<unicode_identifier_whitespace, unicode_identifier_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::star(lex::ascii::is_space);
+    }
+};
 } // namespace tokenizer_ns
 
 void tokenizer(const char* str, const char* end, void (*f)(int, foonathan::lex::token_spelling))
@@ -74,4 +158,107 @@ void tokenizer(const char* str, const char* end, void (*f)(int, foonathan::lex::
     }
 }
 
+void tokenizer_range(const char* str, const char* end,
+                     void (*f)(int, foonathan::lex::token_spelling))
+{
+    using namespace tokenizer_ns;
+    namespace lex = foonathan::lex;
+
+    lex::tokenizer<token_spec> tokenizer(str, end);
+    for (auto cur : lex::make_token_range(tokenizer))
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+}
+
+#if FOONATHAN_LEX_HAS_COROUTINES
+void tokenizer_generator(const char* str, const char* end,
+                         void (*f)(int, foonathan::lex::token_spelling))
+{
+    using namespace tokenizer_ns;
+    namespace lex = foonathan::lex;
+
+    for (auto cur : lex::generate_tokens(lex::tokenizer<token_spec>(str, end)))
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+}
+#endif
+
+void tokenizer_coalesce(const char* str, const char* end,
+                        void (*f)(int, foonathan::lex::token_spelling))
+{
+    using namespace tokenizer_ns;
+    namespace lex = foonathan::lex;
+
+    lex::tokenizer<coalescing_spec> tokenizer(str, end);
+    while (!tokenizer.is_done())
+    {
+        auto cur = tokenizer.peek();
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+        tokenizer.bump();
+    }
+}
+
+void tokenizer_null_terminated(const char* str, const char* end,
+                               void (*f)(int, foonathan::lex::token_spelling))
+{
+    using namespace tokenizer_ns;
+    namespace lex = foonathan::lex;
+
+    lex::tokenizer<null_terminated_spec> tokenizer(str, end);
+    while (!tokenizer.is_done())
+    {
+        auto cur = tokenizer.peek();
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+        tokenizer.bump();
+    }
+}
+
+void tokenizer_buffer(const char* str, const char* end,
+                      void (*f)(int, foonathan::lex::token_spelling))
+{
+    using namespace tokenizer_ns;
+    namespace lex = foonathan::lex;
+
+    // reuse the memory between runs
+    static lex::token_buffer<token_spec> buffer;
+    lex::tokenize_all(str, end, buffer);
+
+    auto kinds   = buffer.kind_ids();
+    auto offsets = buffer.offsets();
+    auto lengths = buffer.lengths();
+    for (auto i = 0u; i != buffer.size(); ++i)
+        if (kinds[i] != 0u)
+            f(kinds[i], lex::token_spelling(str + offsets[i], lengths[i]));
+}
+
+template <class TokenSpec>
+void tokenizer_identifier(const char* str, const char* end,
+                          void (*f)(int, foonathan::lex::token_spelling))
+{
+    namespace lex = foonathan::lex;
+
+    lex::tokenizer<TokenSpec> tokenizer(str, end);
+    while (!tokenizer.is_done())
+    {
+        auto cur = tokenizer.peek();
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+        tokenizer.bump();
+    }
+}
+
+std::size_t tokenizer_parallel(const char* str, const char* end, unsigned thread_count)
+{
+    using namespace tokenizer_ns;
+    namespace lex = foonathan::lex;
+
+    // the input is a null terminated string,
+    // using a different specification also keeps it from affecting the inlining of the others
+    static lex::token_buffer<null_terminated_spec> buffer;
+    lex::tokenize_all(str, end, buffer, thread_count);
+    return buffer.size();
+}
+
 #endif // FOONATHAN_LEX_BM_TOKENIZER_HPP_INCLUDED
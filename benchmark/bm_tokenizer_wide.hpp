@@ -0,0 +1,146 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_BM_TOKENIZER_WIDE_HPP_INCLUDED
+#define FOONATHAN_LEX_BM_TOKENIZER_WIDE_HPP_INCLUDED
+
+#include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace tokenizer_wide_ns
+{
+namespace lex = foonathan::lex;
+
+// all punctuation tokens of C,
+// `tilde` comes first, so it is inserted last and becomes the last child of the root
+using token_spec = lex::token_spec<
+    struct tilde, struct open_paren, struct close_paren, struct open_curly, struct close_curly,
+    struct open_square, struct close_square, struct add, struct sub, struct mul, struct div,
+    struct mod, struct and_, struct xor_, struct or_, struct shift_right, struct shift_left,
+    struct inc, struct dec, struct assign, struct add_assign, struct sub_assign, struct mul_assign,
+    struct div_assign, struct mod_assign, struct and_assign, struct xor_assign, struct or_assign,
+    struct shift_right_assign, struct shift_left_assign, struct equal, struct not_equal,
+    struct less, struct greater, struct less_equal, struct greater_equal, struct logical_and,
+    struct logical_or, struct semicolon, struct comma, struct colon, struct dot, struct ellipsis,
+    struct arrow, struct exclamation_mark, struct question_mark, struct whitespace>;
+
+struct tilde : FOONATHAN_LEX_LITERAL("~")
+{};
+struct open_paren : FOONATHAN_LEX_LITERAL("(")
+{};
+struct close_paren : FOONATHAN_LEX_LITERAL(")")
+{};
+struct open_curly : FOONATHAN_LEX_LITERAL("{")
+{};
+struct close_curly : FOONATHAN_LEX_LITERAL("}")
+{};
+struct open_square : FOONATHAN_LEX_LITERAL("[")
+{};
+struct close_square : FOONATHAN_LEX_LITERAL("]")
+{};
+struct add : FOONATHAN_LEX_LITERAL("+")
+{};
+struct sub : FOONATHAN_LEX_LITERAL("-")
+{};
+struct mul : FOONATHAN_LEX_LITERAL("*")
+{};
+struct div : FOONATHAN_LEX_LITERAL("/")
+{};
+struct mod : FOONATHAN_LEX_LITERAL("%")
+{};
+struct and_ : FOONATHAN_LEX_LITERAL("&")
+{};
+struct xor_ : FOONATHAN_LEX_LITERAL("^")
+{};
+struct or_ : FOONATHAN_LEX_LITERAL("|")
+{};
+struct shift_right : FOONATHAN_LEX_LITERAL(">>")
+{};
+struct shift_left : FOONATHAN_LEX_LITERAL("<<")
+{};
+struct inc : FOONATHAN_LEX_LITERAL("++")
+{};
+struct dec : FOONATHAN_LEX_LITERAL("--")
+{};
+struct assign : FOONATHAN_LEX_LITERAL("=")
+{};
+struct add_assign : FOONATHAN_LEX_LITERAL("+=")
+{};
+struct sub_assign : FOONATHAN_LEX_LITERAL("-=")
+{};
+struct mul_assign : FOONATHAN_LEX_LITERAL("*=")
+{};
+struct div_assign : FOONATHAN_LEX_LITERAL("/=")
+{};
+struct mod_assign : FOONATHAN_LEX_LITERAL("%=")
+{};
+struct and_assign : FOONATHAN_LEX_LITERAL("&=")
+{};
+struct xor_assign : FOONATHAN_LEX_LITERAL("^=")
+{};
+struct or_assign : FOONATHAN_LEX_LITERAL("|=")
+{};
+struct shift_right_assign : FOONATHAN_LEX_LITERAL(">>=")
+{};
+struct shift_left_assign : FOONATHAN_LEX_LITERAL("<<=")
+{};
+struct equal : FOONATHAN_LEX_LITERAL("==")
+{};
+struct not_equal : FOONATHAN_LEX_LITERAL("!=")
+{};
+struct less : FOONATHAN_LEX_LITERAL("<")
+{};
+struct greater : FOONATHAN_LEX_LITERAL(">")
+{};
+struct less_equal : FOONATHAN_LEX_LITERAL("<=")
+{};
+struct greater_equal : FOONATHAN_LEX_LITERAL(">=")
+{};
+struct logical_and : FOONATHAN_LEX_LITERAL("&&")
+{};
+struct logical_or : FOONATHAN_LEX_LITERAL("||")
+{};
+struct semicolon : FOONATHAN_LEX_LITERAL(";")
+{};
+struct comma : FOONATHAN_LEX_LITERAL(",")
+{};
+struct colon : FOONATHAN_LEX_LITERAL(":")
+{};
+struct dot : FOONATHAN_LEX_LITERAL(".")
+{};
+struct ellipsis : FOONATHAN_LEX_LITERAL("...")
+{};
+struct arrow : FOONATHAN_LEX_LITERAL("->")
+{};
+struct exclamation_mark : FOONATHAN_LEX_LITERAL("!")
+{};
+struct question_mark : FOONATHAN_LEX_LITERAL("?")
+{};
+
+struct whitespace : lex::rule_token<whitespace, token_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::star(lex::ascii::is_space);
+    }
+};
+} // namespace tokenizer_wide_ns
+
+void tokenizer_wide(const char* str, const char* end,
+                    void (*f)(int, foonathan::lex::token_spelling))
+{
+    using namespace tokenizer_wide_ns;
+    namespace lex = foonathan::lex;
+
+    lex::tokenizer<token_spec> tokenizer(str, end);
+    while (!tokenizer.is_done())
+    {
+        auto cur = tokenizer.peek();
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+        tokenizer.bump();
+    }
+}
+
+#endif // FOONATHAN_LEX_BM_TOKENIZER_WIDE_HPP_INCLUDED
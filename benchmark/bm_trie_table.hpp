@@ -0,0 +1,86 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_BM_TRIE_TABLE_HPP_INCLUDED
+#define FOONATHAN_LEX_BM_TRIE_TABLE_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+
+#include <boost/mp11/algorithm.hpp>
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace trie_table_ns
+{
+namespace lex = foonathan::lex;
+
+constexpr char digit(std::size_t i) noexcept
+{
+    return "!#$%&*+-./:<=>?^|"[i % 16];
+}
+
+// the literal is the number written in base 16 with punctuation characters as digits,
+// so every literal with more than one character extends a shorter one, like `+` and `+=`
+template <std::size_t Value, std::size_t Length = Value < 16 ? 1 : (Value < 256 ? 2 : 3)>
+struct numbered_literal_base;
+template <std::size_t Value>
+struct numbered_literal_base<Value, 1> : lex::literal_token<digit(Value)>
+{};
+template <std::size_t Value>
+struct numbered_literal_base<Value, 2> : lex::literal_token<digit(Value / 16), digit(Value)>
+{};
+template <std::size_t Value>
+struct numbered_literal_base<Value, 3>
+: lex::literal_token<digit(Value / 256), digit(Value / 16), digit(Value)>
+{};
+
+template <class I>
+struct numbered_literal : numbered_literal_base<I::value + 1>
+{};
+
+template <std::size_t N>
+using literals = boost::mp11::mp_rename<
+    boost::mp11::mp_transform<numbered_literal, boost::mp11::mp_iota_c<N>>, lex::token_spec>;
+
+template <std::size_t N, bool Flat>
+struct token_spec : literals<N>
+{
+    static constexpr bool flat_trie = Flat;
+};
+
+// a pseudo-random sequence of the literals, without whitespace
+template <class TokenSpec>
+std::string make_input(std::size_t size)
+{
+    // without the error and EOF token
+    constexpr auto count = boost::mp11::mp_size<typename TokenSpec::list>::value - 2u;
+
+    std::string result;
+    result.reserve(size);
+
+    std::uint32_t state = 42;
+    while (result.size() < size)
+    {
+        state = state * 1664525u + 1013904223u;
+        result += lex::token_kind<TokenSpec>::from_id((state >> 16) % count + 1).name();
+    }
+    return result;
+}
+} // namespace trie_table_ns
+
+template <class TokenSpec>
+void trie_table(const char* str, const char* end, void (*f)(int, foonathan::lex::token_spelling))
+{
+    foonathan::lex::tokenizer<TokenSpec> tokenizer(str, end);
+    while (!tokenizer.is_done())
+    {
+        auto cur = tokenizer.peek();
+        if (cur)
+            f(cur.kind().get(), cur.spelling());
+        tokenizer.bump();
+    }
+}
+
+#endif // FOONATHAN_LEX_BM_TRIE_TABLE_HPP_INCLUDED
@@ -213,6 +213,14 @@ struct float_literal : lex::basic_rule_token<float_literal, spec>
             return unmatched();
     }
 
+    // As the tokenizer can't look into `try_match()`, we can tell it which characters can start
+    // the token. This is optional and only used to skip invalid characters quickly when the token
+    // specification has `coalesce_errors` enabled.
+    static constexpr bool can_start(char c) noexcept
+    {
+        return is_decimal_digit(c) || c == '.';
+    }
+
     static constexpr bool is_decimal_digit(char c) noexcept
     {
         return lex::ascii::is_digit(c);
@@ -448,15 +456,23 @@ struct question_mark : FOONATHAN_LEX_LITERAL("?")
 
 #if !defined(FOONATHAN_LEX_TEST)
 
-// A simple driver program that tokenizes the standard input.
+// A simple driver program that tokenizes the standard input,
+// or all C files in a directory when given one.
 
+#    include <filesystem>
 #    include <iostream>
 #    include <string>
+#    include <vector>
 
-int main()
+#    include <foonathan/lex/mapped_input.hpp>    // for mapping the files into memory
+#    include <foonathan/lex/tokenize_files.hpp> // for tokenizing many files at once
+
+namespace
 {
-    namespace lex = foonathan::lex;
+namespace lex = foonathan::lex;
 
+int tokenize_stdin()
+{
     // We need to read the input a string.
     // This is required because the tokens are just string views into that string.
     std::string input(std::istreambuf_iterator<char>{std::cin}, std::istreambuf_iterator<char>{});
@@ -478,6 +494,54 @@ int main()
             std::cout << token.name() << ": `"
                       << std::string(token.spelling().data(), token.spelling().size()) << "`\n";
     }
+
+    return 0;
+}
+
+int tokenize_directory(const char* path)
+{
+    // Map all C source and header files into memory.
+    std::vector<lex::mapped_input> inputs;
+    for (auto& entry : std::filesystem::recursive_directory_iterator(path))
+    {
+        auto extension = entry.path().extension();
+        if (!entry.is_regular_file() || (extension != ".c" && extension != ".h"))
+            continue;
+
+        lex::mapped_input input(entry.path().c_str());
+        if (input.error() != 0)
+            std::cerr << "cannot read " << entry.path() << '\n';
+        else
+            inputs.push_back(std::move(input));
+    }
+
+    // Tokenize them on all cores, counting the error tokens.
+    // The callback is invoked concurrently, with a token buffer that is only valid during the call.
+    std::atomic<std::size_t> errors(0);
+    auto                     stats = lex::tokenize_files<C::spec>(
+        inputs.data(), inputs.size(),
+        [&](std::size_t, const lex::token_buffer<C::spec>& tokens) {
+            auto count = std::size_t(0);
+            for (auto i = std::size_t(0); i != tokens.size(); ++i)
+                if (tokens.kind(i).is(lex::error_token{}))
+                    ++count;
+            errors += count;
+        });
+
+    std::cout << stats.files << " files, " << stats.bytes << " bytes, " << stats.tokens
+              << " tokens (" << errors << " errors) in " << stats.seconds() << "s\n";
+    std::cout << stats.bytes_per_second() / 1e6 << " MB/s, "
+              << stats.tokens_per_second() << " tokens/s\n";
+    return 0;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+        return tokenize_directory(argv[1]);
+    else
+        return tokenize_stdin();
 }
 
 #else
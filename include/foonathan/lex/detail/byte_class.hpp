@@ -0,0 +1,97 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_DETAIL_BYTE_CLASS_HPP_INCLUDED
+#define FOONATHAN_LEX_DETAIL_BYTE_CLASS_HPP_INCLUDED
+
+#include <cstddef>
+
+#include <boost/mp11/list.hpp>
+
+#include <foonathan/lex/literal_token.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace detail
+    {
+        namespace mp = boost::mp11;
+
+        // partitions the bytes into equivalence classes:
+        // two bytes are in the same class if they are the same character of a literal
+        // or neither is, and every rule can start with either both or none of them
+        // (as given by its `can_start()`),
+        // so a table-driven matcher only needs one column per class instead of one per byte
+        template <class Literals, class Rules>
+        class byte_class_map;
+        template <class... Literals, class... Rules>
+        class byte_class_map<mp::mp_list<Literals...>, mp::mp_list<Rules...>>
+        {
+        public:
+            constexpr byte_class_map() noexcept : classes_{}, count_(1)
+            {
+                const char* strings[] = {literal_token_type<Literals>::value..., ""};
+                for (auto str : strings)
+                    for (auto cur = str; *cur; ++cur)
+                        split_char(*cur);
+
+                bool dummy[] = {(split_rule<Rules>(), true)..., true};
+                (void)dummy;
+            }
+
+            // the class of the byte, in the range [0, count())
+            constexpr unsigned char operator[](char c) const noexcept
+            {
+                return classes_[static_cast<unsigned char>(c)];
+            }
+
+            constexpr std::size_t count() const noexcept
+            {
+                return count_;
+            }
+
+        private:
+            constexpr void split_char(char c) noexcept
+            {
+                bool set[256] = {};
+                set[static_cast<unsigned char>(c)] = true;
+                split(set);
+            }
+
+            template <class Rule>
+            constexpr void split_rule() noexcept
+            {
+                bool set[256] = {};
+                for (auto i = 0u; i != 256u; ++i)
+                    set[i] = Rule::can_start(static_cast<char>(i));
+                split(set);
+            }
+
+            // splits every class into the bytes in the set and the others,
+            // classes are numbered in the order of their smallest byte
+            constexpr void split(const bool (&set)[256]) noexcept
+            {
+                // the new class + 1 of the bytes of an old class that are (not) in the set
+                std::size_t in[256]  = {};
+                std::size_t out[256] = {};
+
+                count_ = 0;
+                for (auto i = 0u; i != 256u; ++i)
+                {
+                    auto& target = set[i] ? in[classes_[i]] : out[classes_[i]];
+                    if (target == 0u)
+                        target = ++count_;
+                    classes_[i] = static_cast<unsigned char>(target - 1u);
+                }
+            }
+
+            unsigned char classes_[256];
+            std::size_t   count_;
+        };
+    } // namespace detail
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_DETAIL_BYTE_CLASS_HPP_INCLUDED
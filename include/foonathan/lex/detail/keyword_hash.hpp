@@ -0,0 +1,252 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_DETAIL_KEYWORD_HASH_HPP_INCLUDED
+#define FOONATHAN_LEX_DETAIL_KEYWORD_HASH_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+
+#include <foonathan/lex/detail/select_integer.hpp>
+#include <foonathan/lex/detail/simd.hpp>
+#include <foonathan/lex/detail/trie_table.hpp>
+#include <foonathan/lex/match_result.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace detail
+    {
+        //=== key ===//
+        // the index of the n-th byte of the key, alternating between the front and the back
+        constexpr std::size_t keyword_key_position(std::size_t n, std::size_t length) noexcept
+        {
+            auto offset = n / 2u < length ? n / 2u : length - 1u;
+            return n % 2u == 0u ? offset : length - 1u - offset;
+        }
+
+        // the length followed by the given number of bytes,
+        // which identifies the keyword as long as it has less than 256 characters
+        constexpr std::uint64_t keyword_key(const char* str, std::size_t length,
+                                            std::size_t bytes) noexcept
+        {
+            auto key = std::uint64_t(length);
+            for (auto n = std::size_t(0); n != bytes; ++n)
+                key = (key << 8u)
+                      | static_cast<unsigned char>(str[keyword_key_position(n, length)]);
+            return key;
+        }
+
+        //=== hash functions ===//
+        // the number of bits needed to index at least n elements, at least one
+        constexpr std::size_t keyword_hash_bits(std::size_t n) noexcept
+        {
+            auto result = std::size_t(1);
+            while ((std::size_t(1) << result) < n)
+                ++result;
+            return result;
+        }
+
+        constexpr std::size_t keyword_bucket(std::uint64_t key, std::size_t bits) noexcept
+        {
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15u) >> (64u - bits));
+        }
+
+        constexpr std::size_t keyword_slot(std::uint64_t key, std::uint64_t displacement,
+                                           std::size_t bits) noexcept
+        {
+            return static_cast<std::size_t>(
+                ((key ^ (displacement * 0xC2B2AE3D27D4EB4Fu)) * 0xFF51AFD7ED558CCDu)
+                >> (64u - bits));
+        }
+
+        //=== keyword_hash ===//
+        // a perfect hash table of the literals using hash and displace:
+        // the key selects a bucket, whose displacement is chosen,
+        // so that all keys of the bucket are hashed to a free slot
+        //
+        // as at most half of the slots are used, a small displacement is usually enough,
+        // if a bucket needs more than `max_displacement` tries, the table is not valid,
+        // which bounds the work done at compile time
+        template <class Literals>
+        struct keyword_hash_data
+        {
+            static constexpr auto bucket_bits      = keyword_hash_bits(Literals::count / 2u);
+            static constexpr auto bucket_count     = std::size_t(1) << bucket_bits;
+            static constexpr auto slot_bits        = keyword_hash_bits(2u * Literals::count);
+            static constexpr auto slot_count       = std::size_t(1) << slot_bits;
+            static constexpr auto max_key_bytes    = std::size_t(7);
+            static constexpr auto max_displacement = std::uint64_t(256);
+
+            using index_type = select_integer<Literals::count>;
+
+            // whether a perfect hash function was found
+            bool        valid;
+            std::size_t key_bytes;
+            std::size_t max_length;
+            // the length of the keywords, which are at most 255 characters long if valid
+            std::uint8_t  lengths[Literals::count + 1];
+            std::uint8_t  displacement[bucket_count];
+            // the index of the keyword + 1, or 0
+            index_type slots[slot_count];
+
+            constexpr keyword_hash_data() noexcept
+            : valid(false), key_bytes(0), max_length(Literals::max_length()), lengths{},
+              displacement{}, slots{}
+            {
+                valid = build();
+            }
+
+        private:
+            constexpr void compute_keys(std::uint64_t* keys) const noexcept
+            {
+                for (auto i = std::size_t(0); i != Literals::count; ++i)
+                    keys[i] = keyword_key(Literals::strings[i], lengths[i], key_bytes);
+            }
+
+            static constexpr bool unique(const std::uint64_t* keys) noexcept
+            {
+                for (auto i = std::size_t(0); i != Literals::count; ++i)
+                    for (auto j = i + 1u; j != Literals::count; ++j)
+                        if (keys[i] == keys[j])
+                            return false;
+                return true;
+            }
+
+            constexpr bool build() noexcept
+            {
+                if (Literals::count == 0u || max_length > 255u)
+                    return false;
+
+                for (auto i = std::size_t(0); i != Literals::count; ++i)
+                    lengths[i]
+                        = static_cast<std::uint8_t>(Literals::length(Literals::strings[i]));
+
+                // as few bytes as necessary, but at least the first and last one
+                std::uint64_t keys[Literals::count + 1] = {};
+                for (key_bytes = 2u; key_bytes <= max_key_bytes; ++key_bytes)
+                {
+                    compute_keys(keys);
+                    if (unique(keys))
+                        break;
+                }
+                if (key_bytes > max_key_bytes)
+                    return false;
+
+                // sort the keywords by bucket
+                std::size_t bucket_begin[bucket_count + 1] = {};
+                std::size_t bucket_end[bucket_count]       = {};
+                std::size_t members[Literals::count + 1]   = {};
+                for (auto i = std::size_t(0); i != Literals::count; ++i)
+                    ++bucket_begin[keyword_bucket(keys[i], bucket_bits) + 1u];
+                for (auto bucket = std::size_t(0); bucket != bucket_count; ++bucket)
+                {
+                    bucket_begin[bucket + 1u] += bucket_begin[bucket];
+                    bucket_end[bucket] = bucket_begin[bucket];
+                }
+                for (auto i = std::size_t(0); i != Literals::count; ++i)
+                    members[bucket_end[keyword_bucket(keys[i], bucket_bits)]++] = i;
+
+                // place the biggest buckets first, while there are still many free slots
+                for (auto size = Literals::count; size != 0u; --size)
+                    for (auto bucket = std::size_t(0); bucket != bucket_count; ++bucket)
+                        if (bucket_end[bucket] - bucket_begin[bucket] == size
+                            && !place(bucket, keys, members + bucket_begin[bucket],
+                                      members + bucket_end[bucket]))
+                            return false;
+                return true;
+            }
+
+            constexpr bool place(std::size_t bucket, const std::uint64_t* keys,
+                                 const std::size_t* begin, const std::size_t* end) noexcept
+            {
+                for (auto d = std::uint64_t(0); d != max_displacement; ++d)
+                {
+                    auto cur = begin;
+                    for (; cur != end; ++cur)
+                    {
+                        auto& slot = slots[keyword_slot(keys[*cur], d, slot_bits)];
+                        if (slot != 0u)
+                            break;
+                        slot = static_cast<index_type>(*cur + 1u);
+                    }
+
+                    if (cur == end)
+                    {
+                        displacement[bucket] = static_cast<std::uint8_t>(d);
+                        return true;
+                    }
+
+                    // collision, free the slots again
+                    for (auto member = begin; member != cur; ++member)
+                        slots[keyword_slot(keys[*member], d, slot_bits)] = 0;
+                }
+
+                return false;
+            }
+        };
+
+        template <class Data>
+        struct keyword_hash_storage
+        {
+            static constexpr Data table{};
+        };
+
+        template <class Data>
+        constexpr Data keyword_hash_storage<Data>::table;
+
+        // matches a string that is exactly one of the keywords
+        template <class TokenSpec, class... Keywords>
+        class keyword_hash
+        {
+            using literals = trie_table_literals<TokenSpec, Keywords...>;
+            using data     = keyword_hash_data<literals>;
+
+        public:
+            // whether the perfect hash function could be constructed,
+            // otherwise `try_match()` must not be called
+            static constexpr bool is_valid = keyword_hash_storage<data>::table.valid;
+
+            // one hash, one table lookup and one comparison
+            static constexpr match_result<TokenSpec> try_match(const char* str,
+                                                               std::size_t length) noexcept
+            {
+                auto& table = keyword_hash_storage<data>::table;
+                if (length == 0u || length > table.max_length)
+                    return match_result<TokenSpec>::unmatched();
+
+                auto key   = keyword_key(str, length, table.key_bytes);
+                auto d     = table.displacement[keyword_bucket(key, data::bucket_bits)];
+                auto index = table.slots[keyword_slot(key, d, data::slot_bits)];
+                if (index == 0u || table.lengths[index - 1u] != length
+                    || !equal(str, literals::strings[index - 1u], length))
+                    return match_result<TokenSpec>::unmatched();
+
+                return match_result<TokenSpec>::success(token_kind<TokenSpec>::from_id(
+                                                            literals::ids[index - 1u]),
+                                                        length);
+            }
+
+        private:
+            static constexpr bool equal(const char* lhs, const char* rhs,
+                                        std::size_t length) noexcept
+            {
+                if (!is_constant_evaluated())
+                    return std::memcmp(lhs, rhs, length) == 0;
+
+                for (auto i = std::size_t(0); i != length; ++i)
+                    if (lhs[i] != rhs[i])
+                        return false;
+                return true;
+            }
+        };
+
+        template <class TokenSpec, class... Keywords>
+        constexpr bool keyword_hash<TokenSpec, Keywords...>::is_valid;
+    } // namespace detail
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_DETAIL_KEYWORD_HASH_HPP_INCLUDED
@@ -0,0 +1,178 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_DETAIL_KEYWORD_SCAN_HPP_INCLUDED
+#define FOONATHAN_LEX_DETAIL_KEYWORD_SCAN_HPP_INCLUDED
+
+#include <type_traits>
+
+#include <boost/mp11/list.hpp>
+
+#include <foonathan/lex/detail/byte_class.hpp>
+#include <foonathan/lex/detail/reached_end.hpp>
+#include <foonathan/lex/detail/trie_table.hpp>
+#include <foonathan/lex/match_result.hpp>
+#include <foonathan/lex/rule_token.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace detail
+    {
+        namespace mp = boost::mp11;
+
+        //=== identifier shape ===//
+        // whether the rule matches exactly one character, which is then given by `can_start()`
+        template <class Rule>
+        struct is_char_class_rule : std::false_type
+        {};
+        template <>
+        struct is_char_class_rule<token_rule::detail::char_> : std::true_type
+        {};
+        template <typename Predicate>
+        struct is_char_class_rule<token_rule::detail::ascii_predicate<Predicate>> : std::true_type
+        {};
+        template <class R1, class R2>
+        struct is_char_class_rule<token_rule::detail::choice<R1, R2>>
+        : std::integral_constant<bool, is_char_class_rule<R1>::value
+                                           && is_char_class_rule<R2>::value>
+        {};
+
+        // whether the rule is `head + star(tail)` with character class rules
+        template <class Rule>
+        struct is_identifier_shape : std::false_type
+        {};
+        template <class Head, class Tail>
+        struct is_identifier_shape<
+            token_rule::detail::sequence<Head, token_rule::detail::zero_or_more<Tail>>>
+        : std::integral_constant<bool, is_char_class_rule<Head>::value
+                                           && is_char_class_rule<Tail>::value>
+        {};
+
+        template <class Identifier>
+        using identifier_rule_type = decltype(token_rule::r(Identifier::rule()));
+
+        template <class TokenSpec, class Identifier, typename = void>
+        struct has_identifier_shape : std::false_type
+        {};
+        template <class TokenSpec, class Identifier>
+        struct has_identifier_shape<TokenSpec, Identifier, decltype(void(Identifier::rule()))>
+        : std::integral_constant<bool,
+                                 is_identifier_shape<identifier_rule_type<Identifier>>::value
+                                     // the rule is actually used to match it
+                                     && &Identifier::try_match
+                                            == &rule_token<Identifier, TokenSpec>::try_match>
+        {};
+
+        //=== keyword_scan ===//
+        // the head or tail character class of the identifier, as a rule of a trie table
+        template <class TokenSpec, class Identifier, bool Head>
+        struct identifier_char_class
+        {
+            static constexpr bool can_start(char c) noexcept
+            {
+                return Head ? token_rule::r(Identifier::rule()).r1.can_start(c)
+                            : token_rule::r(Identifier::rule()).r2.r.can_start(c);
+            }
+
+            static constexpr bool is_conflicting_literal(token_kind<TokenSpec>) noexcept
+            {
+                return false;
+            }
+        };
+
+        // whether a character is a head or tail character of the identifier
+        template <class Head, class Tail>
+        struct identifier_char_table
+        {
+            static constexpr unsigned char head = 1;
+            static constexpr unsigned char tail = 2;
+
+            unsigned char flags[256];
+
+            constexpr identifier_char_table() noexcept : flags{}
+            {
+                for (auto i = 0u; i != 256u; ++i)
+                {
+                    auto c   = static_cast<char>(i);
+                    flags[i] = static_cast<unsigned char>((Head::can_start(c) ? head : 0u)
+                                                          | (Tail::can_start(c) ? tail : 0u));
+                }
+            }
+
+            constexpr bool is(char c, unsigned char flag) const noexcept
+            {
+                return (flags[static_cast<unsigned char>(c)] & flag) != 0u;
+            }
+        };
+
+        // matches an identifier of the shape `head + star(tail)`
+        // and checks whether it is a keyword at the same time,
+        // by following the transitions of the keyword trie while it matches the tail characters,
+        // so every character is only read once
+        template <class TokenSpec, class Identifier, class... Keywords>
+        class keyword_scan
+        {
+            using head = identifier_char_class<TokenSpec, Identifier, true>;
+            using tail = identifier_char_class<TokenSpec, Identifier, false>;
+
+            using chars = identifier_char_table<head, tail>;
+            using trie  = trie_table_data<TokenSpec, trie_table_literals<TokenSpec, Keywords...>,
+                                         trie_table_rules<TokenSpec>,
+                                         byte_class_map<mp::mp_list<Keywords...>, mp::mp_list<>>>;
+
+        public:
+            static constexpr match_result<TokenSpec> try_match(const char* str,
+                                                               const char* end) noexcept
+            {
+                auto& table = trie_table_storage<trie>::table;
+                auto& ids   = trie_table_storage<chars>::table;
+
+                auto cur = str;
+                if (at_end(cur, end) || !ids.is(*cur, chars::head))
+                    return match_result<TokenSpec>::unmatched();
+
+                // follow the keyword trie as long as the characters are part of the identifier
+                auto state = table.next[0][table.classes[static_cast<unsigned char>(*cur)]];
+                ++cur;
+                while (state != 0u && !at_end(cur, end) && ids.is(*cur, chars::tail))
+                {
+                    state = table.next[state][table.classes[static_cast<unsigned char>(*cur)]];
+                    ++cur;
+                }
+
+                if (state == 0u)
+                {
+                    // no keyword can match anymore, so match the rest of the identifier
+                    while (!at_end(cur, end) && ids.is(*cur, chars::tail))
+                        ++cur;
+                    return match_result<TokenSpec>::success(Identifier{}, bump(str, cur));
+                }
+                else if (table.terminal[state] != 0u)
+                    // the identifier ends where a keyword does
+                    return match_result<TokenSpec>::success(token_kind<TokenSpec>::from_id(
+                                                                table.terminal[state]),
+                                                            bump(str, cur));
+                else
+                    // the identifier is only a prefix of a keyword
+                    return match_result<TokenSpec>::success(Identifier{}, bump(str, cur));
+            }
+
+        private:
+            static constexpr std::size_t bump(const char* begin, const char* end) noexcept
+            {
+                return static_cast<std::size_t>(end - begin);
+            }
+        };
+
+        template <class Head, class Tail>
+        constexpr unsigned char identifier_char_table<Head, Tail>::head;
+        template <class Head, class Tail>
+        constexpr unsigned char identifier_char_table<Head, Tail>::tail;
+    } // namespace detail
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_DETAIL_KEYWORD_SCAN_HPP_INCLUDED
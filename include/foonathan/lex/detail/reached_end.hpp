@@ -0,0 +1,45 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_DETAIL_REACHED_END_HPP_INCLUDED
+#define FOONATHAN_LEX_DETAIL_REACHED_END_HPP_INCLUDED
+
+#include <foonathan/lex/detail/simd.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace detail
+    {
+        // set whenever a matcher looks at the end of the input,
+        // the result of such a match might change if there is more input after it
+        inline bool& reached_end_flag() noexcept
+        {
+            static thread_local bool flag = false;
+            return flag;
+        }
+
+        // nothing is reported during constant evaluation,
+        // or if the compiler can't tell whether that's the case
+        constexpr void report_reached_end() noexcept
+        {
+            if (!is_constant_evaluated())
+                reached_end_flag() = true;
+        }
+
+        // whether `cur` is at the end, reporting it if it is
+        constexpr bool at_end(const char* cur, const char* end) noexcept
+        {
+            if (cur != end)
+                return false;
+
+            report_reached_end();
+            return true;
+        }
+    } // namespace detail
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_DETAIL_REACHED_END_HPP_INCLUDED
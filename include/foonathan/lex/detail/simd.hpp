@@ -0,0 +1,232 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_DETAIL_SIMD_HPP_INCLUDED
+#define FOONATHAN_LEX_DETAIL_SIMD_HPP_INCLUDED
+
+// whether or not we can detect constant evaluation,
+// SIMD code is only used if we can
+#if defined(__has_builtin)
+#    if __has_builtin(__builtin_is_constant_evaluated)
+#        define FOONATHAN_LEX_HAS_IS_CONSTANT_EVALUATED 1
+#    endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#    define FOONATHAN_LEX_HAS_IS_CONSTANT_EVALUATED 1
+#elif defined(_MSC_VER) && _MSC_VER >= 1925
+#    define FOONATHAN_LEX_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+#ifndef FOONATHAN_LEX_HAS_IS_CONSTANT_EVALUATED
+#    define FOONATHAN_LEX_HAS_IS_CONSTANT_EVALUATED 0
+#endif
+
+// whether or not SIMD instructions are used to skip characters,
+// requires SSE2 and uses AVX2 if available
+#ifndef FOONATHAN_LEX_ENABLE_SIMD
+#    if FOONATHAN_LEX_HAS_IS_CONSTANT_EVALUATED                                                   \
+        && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#        define FOONATHAN_LEX_ENABLE_SIMD 1
+#    else
+#        define FOONATHAN_LEX_ENABLE_SIMD 0
+#    endif
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#if FOONATHAN_LEX_ENABLE_SIMD
+#    include <emmintrin.h>
+#    if defined(__AVX2__)
+#        include <immintrin.h>
+#    endif
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#endif
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace detail
+    {
+        constexpr bool is_constant_evaluated() noexcept
+        {
+#if FOONATHAN_LEX_HAS_IS_CONSTANT_EVALUATED
+            return __builtin_is_constant_evaluated();
+#else
+            return true;
+#endif
+        }
+
+        // character classes that can be skipped using SIMD
+        enum class simd_char_class
+        {
+            none,
+            space, // ' ', '\t', '\n', '\v', '\f', '\r'
+            blank, // ' ', '\t'
+            identifier, // ASCII letters, digits and '_'
+        };
+
+#if FOONATHAN_LEX_ENABLE_SIMD
+        inline unsigned count_trailing_zeros(unsigned mask) noexcept
+        {
+#    if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#    else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#    endif
+        }
+
+        // mask of all bytes that are in the character class
+        inline __m128i simd_in_class(simd_char_class cls, __m128i chars) noexcept
+        {
+            if (cls == simd_char_class::identifier)
+            {
+                // setting 0x20 maps upper to lower case letters,
+                // bytes outside of ASCII are negative and stay out of range
+                auto lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+                auto alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                           _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+                auto digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                           _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+                return _mm_or_si128(_mm_or_si128(alpha, digit),
+                                    _mm_cmpeq_epi8(chars, _mm_set1_epi8('_')));
+            }
+
+            auto blank = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')),
+                                      _mm_cmpeq_epi8(chars, _mm_set1_epi8('\t')));
+            if (cls == simd_char_class::blank)
+                return blank;
+
+            // '\t' to '\r' are contiguous
+            auto control = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('\t' - 1)),
+                                         _mm_cmplt_epi8(chars, _mm_set1_epi8('\r' + 1)));
+            return _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')), control);
+        }
+
+#    if defined(__AVX2__)
+        inline __m256i simd_in_class(simd_char_class cls, __m256i chars) noexcept
+        {
+            if (cls == simd_char_class::identifier)
+            {
+                auto lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+                auto alpha
+                    = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+                auto digit
+                    = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+                return _mm256_or_si256(_mm256_or_si256(alpha, digit),
+                                       _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_')));
+            }
+
+            auto blank = _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')),
+                                         _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\t')));
+            if (cls == simd_char_class::blank)
+                return blank;
+
+            auto control
+                = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('\t' - 1)),
+                                   _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), chars));
+            return _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')), control);
+        }
+#    endif
+
+        // returns a pointer to the first character in [cur, end) that isn't in the class,
+        // or to the last block of less than 16 characters
+        inline const char* simd_skip_class(simd_char_class cls, const char* cur,
+                                           const char* end) noexcept
+        {
+#    if defined(__AVX2__)
+            while (end - cur >= 32)
+            {
+                auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+                auto mask  = static_cast<unsigned>(
+                    _mm256_movemask_epi8(simd_in_class(cls, chars)));
+                if (mask != 0xFFFFFFFFu)
+                    return cur + count_trailing_zeros(~mask);
+                cur += 32;
+            }
+#    endif
+
+            while (end - cur >= 16)
+            {
+                auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+                auto mask  = static_cast<unsigned>(_mm_movemask_epi8(simd_in_class(cls, chars)));
+                if (mask != 0xFFFFu)
+                    return cur + count_trailing_zeros(~mask & 0xFFFFu);
+                cur += 16;
+            }
+
+            return cur;
+        }
+#else
+        inline const char* simd_skip_class(simd_char_class, const char* cur, const char*) noexcept
+        {
+            return cur;
+        }
+#endif
+
+        // mask of all bytes in the 64 byte block that are equal to the character,
+        // the first byte is the least significant bit
+        inline std::uint64_t block_char_mask(const char* block, char c) noexcept
+        {
+#if FOONATHAN_LEX_ENABLE_SIMD && defined(__AVX2__)
+            auto needle = _mm256_set1_epi8(c);
+            auto low    = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), needle)));
+            auto high   = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)), needle)));
+            return std::uint64_t(high) << 32 | low;
+#elif FOONATHAN_LEX_ENABLE_SIMD
+            auto needle = _mm_set1_epi8(c);
+            auto result = std::uint64_t(0);
+            for (auto i = 0u; i != 4u; ++i)
+            {
+                auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16u * i));
+                auto mask  = static_cast<std::uint32_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(chars, needle)));
+                result |= std::uint64_t(mask) << (16u * i);
+            }
+            return result;
+#else
+            auto result = std::uint64_t(0);
+            for (auto i = 0u; i != 64u; ++i)
+                if (block[i] == c)
+                    result |= std::uint64_t(1) << i;
+            return result;
+#endif
+        }
+
+        inline std::size_t popcount64(std::uint64_t mask) noexcept
+        {
+#if defined(__GNUC__)
+            return static_cast<std::size_t>(__builtin_popcountll(mask));
+#else
+            auto result = std::size_t(0);
+            for (; mask != 0u; mask &= mask - 1u)
+                ++result;
+            return result;
+#endif
+        }
+
+        // the index of the highest set bit plus one, zero if no bit is set
+        inline std::size_t bit_width64(std::uint64_t mask) noexcept
+        {
+#if defined(__GNUC__)
+            return mask == 0u ? 0u : 64u - static_cast<std::size_t>(__builtin_clzll(mask));
+#else
+            auto result = std::size_t(0);
+            for (; mask != 0u; mask >>= 1)
+                ++result;
+            return result;
+#endif
+        }
+    } // namespace detail
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_DETAIL_SIMD_HPP_INCLUDED
@@ -5,13 +5,24 @@
 #ifndef FOONATHAN_LEX_DETAIL_TRIE_HPP_INCLUDED
 #define FOONATHAN_LEX_DETAIL_TRIE_HPP_INCLUDED
 
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
 #include <boost/mp11/algorithm.hpp>
 #include <boost/mp11/list.hpp>
 #include <boost/mp11/utility.hpp>
 
+#include <foonathan/lex/detail/reached_end.hpp>
 #include <foonathan/lex/detail/select_integer.hpp>
+#include <foonathan/lex/detail/simd.hpp>
 #include <foonathan/lex/match_result.hpp>
 
+// nodes with at least that many children select the child using a table lookup
+#ifndef FOONATHAN_LEX_TRIE_JUMP_TABLE_THRESHOLD
+#    define FOONATHAN_LEX_TRIE_JUMP_TABLE_THRESHOLD 8
+#endif
+
 namespace foonathan
 {
 namespace lex
@@ -33,6 +44,60 @@ namespace lex
         using apply_q_char = typename apply_char_impl<Q::template fn, List>::type;
 
         //=== matcher functions ===//
+        template <class TokenSpec>
+        using child_match_fn = match_result<TokenSpec> (*)(std::size_t, const char*, const char*);
+
+        template <class TokenSpec>
+        constexpr match_result<TokenSpec> unmatched_child(std::size_t, const char*,
+                                                          const char*) noexcept
+        {
+            return match_result<TokenSpec>::unmatched();
+        }
+
+        // maps every byte to the match function of the child with that character
+        template <class TokenSpec, class... Children>
+        struct children_jump_table
+        {
+            child_match_fn<TokenSpec> fns[256];
+
+            constexpr children_jump_table() noexcept : fns{}
+            {
+                for (auto& fn : fns)
+                    fn = &unmatched_child<TokenSpec>;
+
+                bool dummy[]
+                    = {(fns[static_cast<unsigned char>(Children::character)] = &Children::match,
+                        true)...,
+                       true};
+                (void)dummy;
+            }
+        };
+
+        template <class TokenSpec, class... Children>
+        struct jump_table_storage
+        {
+            static constexpr children_jump_table<TokenSpec, Children...> table{};
+        };
+
+        template <class TokenSpec, class... Children>
+        constexpr children_jump_table<TokenSpec, Children...>
+            jump_table_storage<TokenSpec, Children...>::table;
+
+        // whether EOF has to be checked before matching a child with one of the characters,
+        // otherwise the null character at the end of the input doesn't match any child,
+        // and EOF only needs to be checked if no child matched
+        template <class TokenSpec>
+        constexpr bool check_eof_first(std::initializer_list<char> characters) noexcept
+        {
+            if (!null_terminated<TokenSpec>::value)
+                return true;
+
+            for (auto c : characters)
+                if (c == '\0')
+                    return true;
+            return false;
+        }
+
         // tries to match all children
         template <class TokenSpec, class... Children>
         struct children_matcher
@@ -41,10 +106,32 @@ namespace lex
                                                                const char* str,
                                                                const char* end) noexcept
             {
-                // need to check for EOF now
-                if (str == end)
-                    return match_result<TokenSpec>::eof();
+                using use_jump_table = std::integral_constant<
+                    bool, (sizeof...(Children) >= FOONATHAN_LEX_TRIE_JUMP_TABLE_THRESHOLD)>;
+
+                if (check_eof_first<TokenSpec>({Children::character...}))
+                {
+                    // need to check for EOF now
+                    if (at_end(str, end))
+                        return match_result<TokenSpec>::eof();
+                    return dispatch(use_jump_table{}, length_so_far, str, end);
+                }
+                else
+                {
+                    auto result = dispatch(use_jump_table{}, length_so_far, str, end);
+                    if (result.is_unmatched() && at_end(str, end))
+                        return match_result<TokenSpec>::eof();
+                    return result;
+                }
+            }
 
+        private:
+            static constexpr match_result<TokenSpec> dispatch(std::false_type,
+                                                              std::size_t length_so_far,
+                                                              const char* str,
+                                                              const char* end) noexcept
+            {
+                // try one child after the other
                 auto result  = match_result<TokenSpec>::unmatched();
                 bool dummy[] = {(result.is_unmatched() && *str == Children::character
                                  && (result = Children::match(length_so_far, str, end), true))...,
@@ -52,6 +139,16 @@ namespace lex
                 (void)dummy;
                 return result;
             }
+
+            static constexpr match_result<TokenSpec> dispatch(std::true_type,
+                                                              std::size_t length_so_far,
+                                                              const char* str,
+                                                              const char* end) noexcept
+            {
+                // the character selects the child directly
+                auto& table = jump_table_storage<TokenSpec, Children...>::table;
+                return table.fns[static_cast<unsigned char>(*str)](length_so_far, str, end);
+            }
         };
         template <class TokenSpec, class Child>
         struct children_matcher<TokenSpec, Child>
@@ -60,12 +157,24 @@ namespace lex
                                                                const char* str,
                                                                const char* end) noexcept
             {
-                if (str == end)
-                    return match_result<TokenSpec>::eof();
-                else if (*str == Child::character)
-                    return Child::match(length_so_far, str, end);
+                if (check_eof_first<TokenSpec>({Child::character}))
+                {
+                    if (at_end(str, end))
+                        return match_result<TokenSpec>::eof();
+                    else if (*str == Child::character)
+                        return Child::match(length_so_far, str, end);
+                    else
+                        return match_result<TokenSpec>::unmatched();
+                }
                 else
-                    return match_result<TokenSpec>::unmatched();
+                {
+                    if (*str == Child::character)
+                        return Child::match(length_so_far, str, end);
+                    else if (at_end(str, end))
+                        return match_result<TokenSpec>::eof();
+                    else
+                        return match_result<TokenSpec>::unmatched();
+                }
             }
         };
         template <class TokenSpec>
@@ -74,13 +183,81 @@ namespace lex
             static constexpr match_result<TokenSpec> try_match(std::size_t, const char* str,
                                                                const char* end) noexcept
             {
-                if (str == end)
+                if (at_end(str, end))
                     return match_result<TokenSpec>::eof();
                 else
                     return match_result<TokenSpec>::unmatched();
             }
         };
 
+        // compares the characters of a chain of nodes with a single child each
+        template <char... Chars>
+        struct chain_matcher
+        {
+            static constexpr std::size_t length = sizeof...(Chars);
+
+            // compare blocks of 2, 4 or 8 bytes at once
+            using block = std::conditional_t<
+                length <= 2u, std::uint16_t,
+                std::conditional_t<length <= 4u, std::uint32_t, std::uint64_t>>;
+            static constexpr std::size_t block_count
+                = (length + sizeof(block) - 1u) / sizeof(block);
+            static constexpr std::size_t padded_length = block_count * sizeof(block);
+
+            // the characters and the mask of the bytes that are compared, padded with zeroes
+            static constexpr char chars[padded_length] = {Chars...};
+            static constexpr unsigned char mask[padded_length]
+                = {(static_cast<void>(Chars), static_cast<unsigned char>(0xFF))...};
+
+            enum result
+            {
+                mismatch,
+                eof,
+                match,
+            };
+
+            static constexpr result try_match(const char* str, const char* end) noexcept
+            {
+                if (is_constant_evaluated() || static_cast<std::size_t>(end - str) < padded_length)
+                    return try_match_bytewise(str, end);
+                else
+                    return try_match_blocks(str) ? match : mismatch;
+            }
+
+        private:
+            static constexpr result try_match_bytewise(const char* str, const char* end) noexcept
+            {
+                for (auto i = std::size_t(0); i != length; ++i, ++str)
+                {
+                    if (at_end(str, end))
+                        return eof;
+                    else if (*str != chars[i])
+                        return mismatch;
+                }
+                return match;
+            }
+
+            static bool try_match_blocks(const char* str) noexcept
+            {
+                // reads the padding bytes as well, but ignores them in the comparison
+                auto different = block(0);
+                for (auto i = std::size_t(0); i != padded_length; i += sizeof(block))
+                {
+                    block input, expected, relevant;
+                    std::memcpy(&input, str + i, sizeof(block));
+                    std::memcpy(&expected, chars + i, sizeof(block));
+                    std::memcpy(&relevant, mask + i, sizeof(block));
+                    different |= static_cast<block>((input ^ expected) & relevant);
+                }
+                return different == 0u;
+            }
+        };
+
+        template <char... Chars>
+        constexpr char chain_matcher<Chars...>::chars[];
+        template <char... Chars>
+        constexpr unsigned char chain_matcher<Chars...>::mask[];
+
         // tries to match all rules
         template <class TokenSpec, class... Rules>
         struct rule_matcher
@@ -245,6 +422,42 @@ namespace lex
                 }
             };
 
+            // a chain of non-terminal nodes with a single child each, followed by the child,
+            // `C` is the character of the first node, the other characters are compared at once
+            template <class Child, char C, char... Chars>
+            struct chain_node
+            {
+                static constexpr auto is_terminal = false;
+                using children                    = mp::mp_list<Child>;
+                static constexpr auto character   = C;
+
+                // only created after all literals have been inserted
+                template <class Rule>
+                using insert_rule
+                    = chain_node<typename Child::template insert_rule<Rule>, C, Chars...>;
+
+                static constexpr match_result<TokenSpec> match(std::size_t length_so_far,
+                                                               const char* str,
+                                                               const char* end) noexcept
+                {
+                    using chain = chain_matcher<Chars..., Child::character>;
+
+                    switch (chain::try_match(str + 1, end))
+                    {
+                    case chain::mismatch:
+                        return match_result<TokenSpec>::unmatched();
+                    case chain::eof:
+                        return match_result<TokenSpec>::eof();
+                    case chain::match:
+                        break;
+                    }
+
+                    // the child matches its own character again, which can't fail
+                    return Child::match(length_so_far + sizeof...(Chars) + 1u,
+                                        str + sizeof...(Chars) + 1u, end);
+                }
+            };
+
             // the root node, with additional rules
             template <class ChildNodes = mp::mp_list<>, class Rules = mp::mp_list<>>
             struct root_node
@@ -321,6 +534,47 @@ namespace lex
                 };
             };
 
+            //=== path compression ===//
+            template <class Node>
+            struct compress_impl;
+
+            template <class Nodes>
+            using compress_nodes = mp::mp_transform_q<mp::mp_quote_trait<compress_impl>, Nodes>;
+
+            // collects the characters of non-terminal nodes with a single child
+            template <class Node, char... Chars>
+            struct chain_impl
+            {
+                using type = chain_node<typename compress_impl<Node>::type, Chars...>;
+            };
+            template <char C, class Child, char... Chars>
+            struct chain_impl<non_terminal_node<C, mp::mp_list<Child>>, Chars...>
+            : chain_impl<Child, Chars..., C>
+            {};
+
+            template <class ChildNodes, class Rules>
+            struct compress_impl<root_node<ChildNodes, Rules>>
+            {
+                using type = root_node<compress_nodes<ChildNodes>, Rules>;
+            };
+            template <char C, token_kind_detail::id_type<TokenSpec> Id, class ChildNodes,
+                      class Rules>
+            struct compress_impl<terminal_node<C, Id, ChildNodes, Rules>>
+            {
+                using type = terminal_node<C, Id, compress_nodes<ChildNodes>, Rules>;
+            };
+            template <char C, class ChildNodes>
+            struct compress_impl<non_terminal_node<C, ChildNodes>>
+            {
+                using type = non_terminal_node<C, compress_nodes<ChildNodes>>;
+            };
+            // a chain is only worth it if it compares at least two characters at once
+            template <char C, char C2, class Grandchild>
+            struct compress_impl<
+                non_terminal_node<C, mp::mp_list<non_terminal_node<C2, mp::mp_list<Grandchild>>>>>
+            : chain_impl<non_terminal_node<C2, mp::mp_list<Grandchild>>, C>
+            {};
+
         public:
             // an empty trie
             using empty = root_node<>;
@@ -333,6 +587,11 @@ namespace lex
             // inserts a rule
             template <class Root, class Rule>
             using insert_rule = typename Root::template insert_rule<Rule>;
+
+            // replaces chains of non-terminal nodes with a single child by a single node,
+            // no literals can be inserted afterwards
+            template <class Root>
+            using compress = typename compress_impl<Root>::type;
         };
     } // namespace detail
 } // namespace lex
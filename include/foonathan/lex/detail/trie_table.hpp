@@ -0,0 +1,301 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_DETAIL_TRIE_TABLE_HPP_INCLUDED
+#define FOONATHAN_LEX_DETAIL_TRIE_TABLE_HPP_INCLUDED
+
+#include <cstdint>
+
+#include <boost/mp11/list.hpp>
+
+#include <foonathan/lex/detail/byte_class.hpp>
+#include <foonathan/lex/detail/reached_end.hpp>
+#include <foonathan/lex/detail/select_integer.hpp>
+#include <foonathan/lex/literal_token.hpp>
+#include <foonathan/lex/match_result.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace detail
+    {
+        namespace mp = boost::mp11;
+
+        // the number of states and whether a literal was inserted twice
+        struct trie_table_shape
+        {
+            std::size_t states;
+            bool        duplicate;
+        };
+
+        // the literal tokens of a trie table
+        template <class TokenSpec, class... Literals>
+        struct trie_table_literals
+        {
+            static constexpr std::size_t count = sizeof...(Literals);
+
+            // one more element, as arrays can't be empty
+            static constexpr const char* strings[count + 1]
+                = {literal_token_type<Literals>::value..., nullptr};
+            static constexpr token_kind_detail::id_type<TokenSpec> ids[count + 1]
+                = {token_kind<TokenSpec>(Literals{}).get()..., 0};
+
+            static constexpr std::size_t length(const char* str) noexcept
+            {
+                auto result = std::size_t(0);
+                while (str[result])
+                    ++result;
+                return result;
+            }
+
+            static constexpr std::size_t max_length() noexcept
+            {
+                auto result = std::size_t(0);
+                for (auto i = std::size_t(0); i != count; ++i)
+                    if (length(strings[i]) > result)
+                        result = length(strings[i]);
+                return result;
+            }
+
+            static constexpr std::size_t max_states() noexcept
+            {
+                auto result = std::size_t(1);
+                for (auto i = std::size_t(0); i != count; ++i)
+                    result += length(strings[i]);
+                return result;
+            }
+
+            // builds the trie with sibling lists to count the states
+            static constexpr trie_table_shape shape() noexcept
+            {
+                char        character[max_states()]    = {};
+                std::size_t first_child[max_states()]  = {};
+                std::size_t next_sibling[max_states()] = {};
+                bool        is_terminal[max_states()]  = {};
+
+                auto result = trie_table_shape{1, false};
+                for (auto i = std::size_t(0); i != count; ++i)
+                {
+                    auto state = std::size_t(0);
+                    for (auto cur = strings[i]; *cur; ++cur)
+                    {
+                        auto child = first_child[state];
+                        while (child != 0u && character[child] != *cur)
+                            child = next_sibling[child];
+
+                        if (child == 0u)
+                        {
+                            child               = result.states++;
+                            character[child]    = *cur;
+                            next_sibling[child] = first_child[state];
+                            first_child[state]  = child;
+                        }
+                        state = child;
+                    }
+
+                    if (is_terminal[state])
+                        result.duplicate = true;
+                    is_terminal[state] = true;
+                }
+                return result;
+            }
+        };
+
+        template <class TokenSpec, class... Literals>
+        constexpr const char* trie_table_literals<TokenSpec, Literals...>::strings[];
+        template <class TokenSpec, class... Literals>
+        constexpr token_kind_detail::id_type<TokenSpec>
+            trie_table_literals<TokenSpec, Literals...>::ids[];
+
+        // the rules of a trie table, a rule mask has the n-th bit set for the n-th rule
+        template <class TokenSpec, class... Rules>
+        struct trie_table_rules
+        {
+            static_assert(sizeof...(Rules) <= 64u, "too many rules");
+
+            // the mask of the rules that conflict with the literal
+            static constexpr std::uint64_t conflicting(token_kind<TokenSpec> kind) noexcept
+            {
+                auto result  = std::uint64_t(0);
+                auto bit     = std::uint64_t(1);
+                bool dummy[] = {(result |= Rules::is_conflicting_literal(kind) ? bit : 0u,
+                                 bit <<= 1, true)...,
+                                true};
+                (void)dummy;
+                (void)kind;
+                return result;
+            }
+
+            // the mask of the rules that can start with the character
+            static constexpr std::uint64_t starting(char c) noexcept
+            {
+                auto result  = std::uint64_t(0);
+                auto bit     = std::uint64_t(1);
+                bool dummy[] = {(result |= Rules::can_start(c) ? bit : 0u, bit <<= 1, true)...,
+                                true};
+                (void)dummy;
+                (void)c;
+                return result;
+            }
+
+            // tries to match the rules of the mask in order
+            static constexpr match_result<TokenSpec> try_match(std::uint64_t mask, const char* str,
+                                                               const char* end) noexcept
+            {
+                auto result  = match_result<TokenSpec>::unmatched();
+                auto bit     = std::uint64_t(1);
+                bool dummy[] = {(result.is_unmatched() && (mask & bit) != 0u
+                                     && (result = Rules::try_match(str, end), true),
+                                 bit <<= 1, true)...,
+                                true};
+                (void)dummy;
+                (void)str;
+                (void)end;
+                return result;
+            }
+        };
+
+        // the transition table of the trie of the literals
+        template <class TokenSpec, class Literals, class Rules, class Classes>
+        struct trie_table_data
+        {
+            static constexpr auto state_count = Literals::shape().states;
+            static constexpr auto class_count = Classes{}.count();
+            static_assert(!Literals::shape().duplicate, "duplicate string insert into trie");
+
+            using state_type = select_integer<state_count - 1u>;
+            using class_type = select_integer<class_count - 1u>;
+            using id_type    = token_kind_detail::id_type<TokenSpec>;
+            using depth_type = select_integer<Literals::max_length()>;
+
+            class_type classes[256];
+            // 0 is the root, which is never the target of a transition
+            state_type next[state_count][class_count];
+            // the id of the literal that ends in the state, or 0 (the error token)
+            id_type terminal[state_count];
+            // the closest state on the path to the state that is a terminal, or 0
+            state_type parent_terminal[state_count];
+            // the length of the path to the state
+            depth_type depth[state_count];
+            // the rules that conflict with the literal of a terminal
+            std::uint64_t rules[state_count];
+            // the rules that can start with a character of the class
+            std::uint64_t start_rules[class_count];
+
+            constexpr trie_table_data() noexcept
+            : classes{}, next{}, terminal{}, parent_terminal{}, depth{}, rules{}, start_rules{}
+            {
+                constexpr auto map = Classes{};
+                for (auto i = 0u; i != 256u; ++i)
+                {
+                    auto c                  = static_cast<char>(i);
+                    classes[i]              = static_cast<class_type>(map[c]);
+                    start_rules[classes[i]] = Rules::starting(c);
+                }
+
+                state_type parent[state_count] = {};
+                auto       new_state           = state_type(1);
+                for (auto i = std::size_t(0); i != Literals::count; ++i)
+                {
+                    auto state = state_type(0);
+                    for (auto cur = Literals::strings[i]; *cur; ++cur)
+                    {
+                        auto& target = next[state][classes[static_cast<unsigned char>(*cur)]];
+                        if (target == 0u)
+                        {
+                            target         = new_state++;
+                            parent[target] = state;
+                            depth[target]  = static_cast<depth_type>(depth[state] + 1u);
+                        }
+                        state = target;
+                    }
+
+                    terminal[state] = Literals::ids[i];
+                    rules[state]
+                        = Rules::conflicting(token_kind<TokenSpec>::from_id(Literals::ids[i]));
+                }
+
+                // parents have lower indices than their children
+                for (auto state = std::size_t(1); state != state_count; ++state)
+                {
+                    auto p                 = parent[state];
+                    parent_terminal[state] = terminal[p] != 0u ? p : parent_terminal[p];
+                }
+            }
+        };
+
+        template <class Data>
+        struct trie_table_storage
+        {
+            static constexpr Data table{};
+        };
+
+        template <class Data>
+        constexpr Data trie_table_storage<Data>::table;
+
+        // the same trie as `detail::trie`, but as a flat state transition table
+        template <class TokenSpec, class Literals, class Rules>
+        class trie_table;
+        template <class TokenSpec, class... Literals, class... Rules>
+        class trie_table<TokenSpec, mp::mp_list<Literals...>, mp::mp_list<Rules...>>
+        {
+            using rules   = trie_table_rules<TokenSpec, Rules...>;
+            using classes = byte_class_map<mp::mp_list<Literals...>, mp::mp_list<Rules...>>;
+            using data    = trie_table_data<TokenSpec, trie_table_literals<TokenSpec, Literals...>,
+                                         rules, classes>;
+
+        public:
+            static constexpr match_result<TokenSpec> try_match(const char* str,
+                                                               const char* end) noexcept
+            {
+                if (at_end(str, end))
+                    return match_result<TokenSpec>::eof();
+
+                auto& table = trie_table_storage<data>::table;
+
+                // only the rules that can start with the first character can match
+                auto first_class = table.classes[static_cast<unsigned char>(*str)];
+                auto start_rules = table.start_rules[first_class];
+
+                // follow the transitions as far as possible
+                auto state = typename data::state_type(0);
+                for (auto cur = str; !at_end(cur, end); ++cur)
+                {
+                    auto next = table.next[state][table.classes[static_cast<unsigned char>(*cur)]];
+                    if (next == 0u)
+                        break;
+                    state = next;
+                }
+
+                // the longest literal that matched wins, unless a conflicting rule matches,
+                // a rule that fails lets the shorter literals check their rules
+                auto terminal = table.terminal[state] != 0u ? state : table.parent_terminal[state];
+                for (; terminal != 0u; terminal = table.parent_terminal[terminal])
+                {
+                    auto mask        = table.rules[terminal] & start_rules;
+                    auto rule_result = mask == 0u ? match_result<TokenSpec>::unmatched()
+                                                  : rules::try_match(mask, str, end);
+                    if (rule_result.is_unmatched())
+                        return match_result<TokenSpec>::success(token_kind<TokenSpec>::from_id(
+                                                                    table.terminal[terminal]),
+                                                                table.depth[terminal]);
+                    else if (rule_result.is_success() || table.parent_terminal[terminal] == 0u)
+                        return rule_result;
+                }
+
+                // no literal matched, try the rules
+                auto rule_result = rules::try_match(start_rules, str, end);
+                if (rule_result.is_matched())
+                    return rule_result;
+
+                // nothing matched, error
+                return match_result<TokenSpec>::error(1);
+            }
+        };
+    } // namespace detail
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_DETAIL_TRIE_TABLE_HPP_INCLUDED
@@ -0,0 +1,440 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_DETAIL_UNICODE_TABLES_HPP_INCLUDED
+#define FOONATHAN_LEX_DETAIL_UNICODE_TABLES_HPP_INCLUDED
+
+#include <cstdint>
+
+// generated from the XID_Start and XID_Continue properties of Unicode 14.0.0,
+// do not edit manually, use tools/generate_unicode_tables.py instead
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace unicode
+    {
+        namespace detail
+        {
+            // the tables only cover the code points below `xid_table_limit`,
+            // all code points above are neither XID_Start nor XID_Continue,
+            // except for the variation selectors U+E0100 to U+E01EF which are XID_Continue
+            constexpr char32_t xid_table_limit = 0x40000;
+
+            // `stage1[cp >> 8]` is the index of the block of the code point,
+            // the block stores one bit per code point in eight 32 bit words
+            template <typename = void>
+            struct xid_tables
+            {
+                static constexpr std::uint8_t stage1[1024] = {
+                    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                    16, 1, 17, 18, 19, 1, 20, 21, 22, 23, 24, 25, 26, 27, 1, 28,
+                    29, 30, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 32, 33, 31, 31,
+                    34, 35, 31, 31, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 36, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 37, 1, 38, 39, 40, 41, 42, 43, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 44, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 1, 45, 46, 47, 48, 49, 50,
+                    51, 52, 53, 54, 55, 56, 1, 57, 58, 59, 60, 61, 62, 63, 64, 65,
+                    66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 31, 77, 78, 79, 80,
+                    1, 1, 1, 81, 82, 83, 31, 31, 31, 31, 31, 31, 31, 31, 31, 84,
+                    1, 1, 1, 1, 85, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 1, 1, 86, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 1, 1, 87, 88, 31, 31, 89, 90,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 91, 1, 1, 1, 1, 92, 93, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 94,
+                    1, 95, 96, 31, 31, 31, 31, 31, 31, 31, 31, 31, 97, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 98,
+                    31, 99, 100, 31, 101, 102, 103, 104, 31, 31, 105, 31, 31, 31, 31, 106,
+                    107, 108, 109, 31, 31, 31, 31, 110, 111, 112, 31, 31, 31, 31, 113, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 114, 31, 31, 31, 31,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 115, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 116, 117, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 118, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 119, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 1, 1, 120, 31, 31, 31, 31, 31,
+                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1, 1, 1, 121, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                };
+                static constexpr std::uint32_t start[976] = {
+                    0x00000000, 0x00000000, 0x07FFFFFE, 0x07FFFFFE, 0x00000000, 0x04200400,
+                    0xFF7FFFFF, 0xFF7FFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0003FFC3, 0x0000501F,
+                    0x00000000, 0x00000000, 0x00000000, 0xB8DF0000, 0xFFFFD740, 0xFFFFFFFB,
+                    0xFFFFFFFF, 0xFFBFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFC03, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFEFFFF,
+                    0x027FFFFF, 0xFFFFFFFF, 0x000001FF, 0x00000000, 0xFFFF0000, 0x000787FF,
+                    0x00000000, 0xFFFFFFFF, 0x000007FF, 0xFFFEC000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x002FFFFF, 0x9C00C060, 0xFFFD0000, 0x0000FFFF, 0xFFFFE000, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x0002003F, 0xFFFFFC00, 0x043007FF, 0x043FFFFF, 0x00000110,
+                    0x01FFFFFF, 0xFFFF07FF, 0x00007EFF, 0xFFFFFFFF, 0x000003FF, 0x00000000,
+                    0xFFFFFFF0, 0x23FFFFFF, 0xFF010000, 0xFFFE0003, 0xFFF99FE1, 0x23C5FDFF,
+                    0xB0004000, 0x10030003, 0xFFF987E0, 0x036DFDFF, 0x5E000000, 0x001C0000,
+                    0xFFFBBFE0, 0x23EDFDFF, 0x00010000, 0x02000003, 0xFFF99FE0, 0x23EDFDFF,
+                    0xB0000000, 0x00020003, 0xD63DC7E8, 0x03FFC718, 0x00010000, 0x00000000,
+                    0xFFFDDFE0, 0x23FFFDFF, 0x27000000, 0x00000003, 0xFFFDDFE1, 0x23EFFDFF,
+                    0x60000000, 0x00060003, 0xFFFDDFF0, 0x27FFFFFF, 0x80704000, 0xFC000003,
+                    0xFC7FFFE0, 0x2FFBFFFF, 0x0000007F, 0x00000000, 0xFFFFFFFE, 0x0005FFFF,
+                    0x0000007F, 0x00000000, 0xFFFFF7D6, 0x2005FFAF, 0xF000005F, 0x00000000,
+                    0x00000001, 0x00000000, 0xFFFFFEFF, 0x00001FFF, 0x00001F00, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0x800007FF, 0x3C3F0000, 0xFFE1C062,
+                    0x00004003, 0xFFFFFFFF, 0xFFFF20BF, 0xF7FFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x3D7F3DFF, 0xFFFFFFFF, 0xFFFF3DFF, 0x7F3DFFFF, 0xFF7FFF3D, 0xFFFFFFFF,
+                    0xFF3DFFFF, 0xFFFFFFFF, 0x07FFFFFF, 0x00000000, 0x0000FFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x3F3FFFFF, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFF9FFF, 0x07FFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0x01FFC7FF,
+                    0x8003FFFF, 0x0003FFFF, 0x0003FFFF, 0x0001DFFF, 0xFFFFFFFF, 0x000FFFFF,
+                    0x10800000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x01FFFFFF,
+                    0xFFFFFFFF, 0xFFFF05FF, 0xFFFFFFFF, 0x003FFFFF, 0x7FFFFFFF, 0x00000000,
+                    0xFFFF0000, 0x001F3FFF, 0xFFFFFFFF, 0xFFFF0FFF, 0x000003FF, 0x00000000,
+                    0x007FFFFF, 0xFFFFFFFF, 0x001FFFFF, 0x00000000, 0x00000000, 0x00000080,
+                    0x00000000, 0x00000000, 0xFFFFFFE0, 0x000FFFFF, 0x00001FE0, 0x00000000,
+                    0xFFFFFFF8, 0xFC00C001, 0xFFFFFFFF, 0x0000003F, 0xFFFFFFFF, 0x0000000F,
+                    0xFC00E000, 0x3FFFFFFF, 0xFFFF01FF, 0xE7FFFFFF, 0x00000000, 0x046FDE00,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x00000000, 0x00000000, 0x3F3FFFFF, 0xFFFFFFFF, 0xAAFF3F3F, 0x3FFFFFFF,
+                    0xFFFFFFFF, 0x5FDFFFFF, 0x0FCF1FDC, 0x1FDC1FFF, 0x00000000, 0x00000000,
+                    0x00000000, 0x80020000, 0x1FFF0000, 0x00000000, 0x00000000, 0x00000000,
+                    0x3F2FFC84, 0xF3FFFD50, 0x000043E0, 0xFFFFFFFF, 0x000001FF, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x000C781F,
+                    0xFFFFFFFF, 0xFFFF20BF, 0xFFFFFFFF, 0x000080FF, 0x007FFFFF, 0x7F7F7F7F,
+                    0x7F7F7F7F, 0x00000000, 0x000000E0, 0x1F3E03FE, 0xFFFFFFFE, 0xFFFFFFFF,
+                    0xE07FFFFF, 0xFFFFFFFE, 0xFFFFFFFF, 0xF7FFFFFF, 0xFFFFFFE0, 0xFFFEFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x00007FFF, 0xFFFFFFFF, 0x00000000, 0xFFFF0000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x00001FFF, 0x00000000, 0xFFFF0000, 0x3FFFFFFF, 0xFFFF1FFF, 0x00000C00,
+                    0xFFFFFFFF, 0x80007FFF, 0x3FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0000FFFF,
+                    0xFF800000, 0xFFFFFFFC, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFF9FF, 0xFFFFFFFF,
+                    0x03EB07FF, 0xFFFC0000, 0xFFFFF7BB, 0x00000007, 0xFFFFFFFF, 0x000FFFFF,
+                    0xFFFFFFFC, 0x000FFFFF, 0x00000000, 0x68FC0000, 0xFFFFFC00, 0xFFFF003F,
+                    0x0000007F, 0x1FFFFFFF, 0xFFFFFFF0, 0x0007FFFF, 0x00008000, 0x7C00FFDF,
+                    0xFFFFFFFF, 0x000001FF, 0x00000FF7, 0xC47FFFFF, 0xFFFFFFFF, 0x3E62FFFF,
+                    0x38000005, 0x001C07FF, 0x007E7E7E, 0xFFFF7F7F, 0xF7FFFFFF, 0xFFFF03FF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000007, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF000F, 0xFFFFF87F, 0x0FFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF3FFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x03FFFFFF, 0x00000000, 0xA0F8007F, 0x5F7FFDFF, 0xFFFFFFDB, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x0003FFFF, 0xFFF80000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x3FFFFFFF, 0xFFFFFFF0, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x3FFFFFFF, 0xFFFF0000, 0xFFFFFFFF, 0xFFFCFFFF, 0xFFFFFFFF,
+                    0x000000FF, 0x03FF0000, 0x00000000, 0x00000000, 0x00000000, 0xAA8A0000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x1FFFFFFF, 0x00000000, 0x07FFFFFE,
+                    0x07FFFFFE, 0xFFFFFFC0, 0x3FFFFFFF, 0x7FFFFFFF, 0x1CFCFCFC, 0x00000000,
+                    0xFFFFEFFF, 0xB7FFFF7F, 0x3FFF3FFF, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x07FFFFFF, 0x00000000, 0x00000000, 0xFFFFFFFF, 0x001FFFFF,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x1FFFFFFF, 0xFFFFFFFF, 0x0001FFFF, 0x00000000,
+                    0xFFFFFFFF, 0xFFFFE000, 0xFFFF07FF, 0x003FFFFF, 0x3FFFFFFF, 0xFFFFFFFF,
+                    0x003EFF0F, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x3FFFFFFF, 0xFFFF0000, 0xFF0FFFFF, 0x0FFFFFFF, 0xFFFFFFFF, 0xFFFF00FF,
+                    0xFFFFFFFF, 0xF7FF000F, 0xFFB7F7FF, 0x1BFBFFFB, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0x007FFFFF, 0x003FFFFF, 0x000000FF, 0xFFFFFFBF, 0x07FDFFFF,
+                    0x00000000, 0x00000000, 0xFFFFFD3F, 0x91BFFFFF, 0x003FFFFF, 0x007FFFFF,
+                    0x7FFFFFFF, 0x00000000, 0x00000000, 0x0037FFFF, 0x003FFFFF, 0x03FFFFFF,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xC0FFFFFF, 0x00000000, 0x00000000,
+                    0xFEEF0001, 0x003FFFFF, 0x00000000, 0x1FFFFFFF, 0x1FFFFFFF, 0x00000000,
+                    0xFFFFFEFF, 0x0000001F, 0xFFFFFFFF, 0x003FFFFF, 0x003FFFFF, 0x0007FFFF,
+                    0x0003FFFF, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x000001FF, 0x00000000, 0xFFFFFFFF, 0x0007FFFF, 0xFFFFFFFF, 0x0007FFFF,
+                    0xFFFFFFFF, 0x0000000F, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0x000303FF, 0x00000000, 0x00000000, 0x1FFFFFFF, 0xFFFF0080,
+                    0x0000003F, 0xFFFF0000, 0x00000003, 0xFFFF0000, 0x0000001F, 0x007FFFFF,
+                    0xFFFFFFF8, 0x00FFFFFF, 0x00000000, 0x00260000, 0xFFFFFFF8, 0x0000FFFF,
+                    0xFFFF0000, 0x000001FF, 0xFFFFFFF8, 0x0000007F, 0xFFFF0090, 0x0047FFFF,
+                    0xFFFFFFF8, 0x0007FFFF, 0x1400001E, 0x00000000, 0xFFFBFFFF, 0x00000FFF,
+                    0x00000000, 0x00000000, 0xBFFFBD7F, 0xFFFF01FF, 0x7FFFFFFF, 0x00000000,
+                    0xFFF99FE0, 0x23EDFDFF, 0xE0010000, 0x00000003, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0x001FFFFF, 0x80000780, 0x00000003,
+                    0xFFFFFFFF, 0x0000FFFF, 0x000000B0, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0x00007FFF, 0x0F000000, 0x00000000,
+                    0xFFFFFFFF, 0x0000FFFF, 0x00000010, 0x00000000, 0xFFFFFFFF, 0x010007FF,
+                    0x00000000, 0x00000000, 0x07FFFFFF, 0x00000000, 0x0000007F, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0x00000FFF,
+                    0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x80000000,
+                    0xFF6FF27F, 0x8000FFFF, 0x00000002, 0x00000000, 0x00000000, 0xFFFFFCFF,
+                    0x0001FFFF, 0x0000000A, 0xFFFFF801, 0x0407FFFF, 0xF0010000, 0xFFFFFFFF,
+                    0x200003FF, 0xFFFF0000, 0xFFFFFFFF, 0x01FFFFFF, 0xFFFFFDFF, 0x00007FFF,
+                    0x00000001, 0xFFFC0000, 0x0000FFFF, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFB7F, 0x0001FFFF, 0x00000040, 0xFFFFFDBF, 0x010003FF, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x0007FFFF, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00010000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FFFFFF, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00007FFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x0000000F, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFF0000, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x0001FFFF, 0xFFFFFFFF, 0x00007FFF, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x0000007F, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0x01FFFFFF, 0x7FFFFFFF, 0xFFFF0000, 0xFFFFFFFF, 0x7FFFFFFF,
+                    0xFFFF0000, 0x00003FFF, 0xFFFFFFFF, 0x0000FFFF, 0x0000000F, 0xE0FFFFF8,
+                    0x0000FFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x000107FF, 0x00000000, 0xFFF80000, 0x00000000,
+                    0x00000000, 0x0000000B, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00FFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x003FFFFF, 0x00000000,
+                    0x000001FF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x6FEF0000, 0xFFFFFFFF, 0x00000007,
+                    0x00070000, 0xFFFF00F0, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x0FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x1FFF07FF,
+                    0x03FF01FF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFDFFFFF, 0xFFFFFFFF, 0xDFFFFFFF, 0xEBFFDE64, 0xFFFFFFEF, 0xFFFFFFFF,
+                    0xDFDFE7BF, 0x7BFFFFFF, 0xFFFDFC5F, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFF3F, 0xF7FFFFFD, 0xF7FFFFFF, 0xFFDFFFFF, 0xFFDFFFFF,
+                    0xFFFF7FFF, 0xFFFF7FFF, 0xFFFFFDFF, 0xFFFFFDFF, 0x00000FF7, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x7FFFFFFF, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0x3F801FFF, 0x00004000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFF0000, 0x00003FFF, 0xFFFFFFFF, 0x00000FFF, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x7FFF6F7F,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x0000001F, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x0000080F, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFEF, 0x0AF7FE96,
+                    0xAA96EA84, 0x5EF7F796, 0x0FFFFBFF, 0x0FFFFBEE, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF, 0x01FFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x3FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFF0003, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000001,
+                    0x3FFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x000007FF, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                };
+                static constexpr std::uint32_t continue_[976] = {
+                    0x00000000, 0x03FF0000, 0x87FFFFFE, 0x07FFFFFE, 0x00000000, 0x04A00400,
+                    0xFF7FFFFF, 0xFF7FFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0003FFC3, 0x0000501F,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xB8DFFFFF, 0xFFFFD7C0, 0xFFFFFFFB,
+                    0xFFFFFFFF, 0xFFBFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFCFB, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFEFFFF,
+                    0x027FFFFF, 0xFFFFFFFF, 0xFFFE01FF, 0xBFFFFFFF, 0xFFFF00B6, 0x000787FF,
+                    0x07FF0000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFC3FF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x9FEFFFFF, 0x9FFFFDFF, 0xFFFF0000, 0xFFFFFFFF, 0xFFFFE7FF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x0003FFFF, 0xFFFFFFFF, 0x243FFFFF, 0xFFFFFFFF, 0x00003FFF,
+                    0x0FFFFFFF, 0xFFFF07FF, 0xFF007EFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFB,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFEFFCF, 0xFFF99FEF, 0xF3C5FDFF,
+                    0xB080799F, 0x5003FFCF, 0xFFF987EE, 0xD36DFDFF, 0x5E023987, 0x003FFFC0,
+                    0xFFFBBFEE, 0xF3EDFDFF, 0x00013BBF, 0xFE00FFCF, 0xFFF99FEE, 0xF3EDFDFF,
+                    0xB0E0399F, 0x0002FFCF, 0xD63DC7EC, 0xC3FFC718, 0x00813DC7, 0x0000FFC0,
+                    0xFFFDDFFF, 0xF3FFFDFF, 0x27603DDF, 0x0000FFCF, 0xFFFDDFEF, 0xF3EFFDFF,
+                    0x60603DDF, 0x0006FFCF, 0xFFFDDFFF, 0xFFFFFFFF, 0x80F07DDF, 0xFC00FFCF,
+                    0xFC7FFFEE, 0x2FFBFFFF, 0xFF5F847F, 0x000CFFC0, 0xFFFFFFFE, 0x07FFFFFF,
+                    0x03FF7FFF, 0x00000000, 0xFFFFF7D6, 0x3FFFFFAF, 0xF3FF3F5F, 0x00000000,
+                    0x03000001, 0xC2A003FF, 0xFFFFFEFF, 0xFFFE1FFF, 0xFEFFFFDF, 0x1FFFFFFF,
+                    0x00000040, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF03FF, 0xFFFFFFFF,
+                    0x3FFFFFFF, 0xFFFFFFFF, 0xFFFF20BF, 0xF7FFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x3D7F3DFF, 0xFFFFFFFF, 0xFFFF3DFF, 0x7F3DFFFF, 0xFF7FFF3D, 0xFFFFFFFF,
+                    0xFF3DFFFF, 0xFFFFFFFF, 0xE7FFFFFF, 0x0003FE00, 0x0000FFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x3F3FFFFF, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFF9FFF, 0x07FFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0x01FFC7FF,
+                    0x803FFFFF, 0x001FFFFF, 0x000FFFFF, 0x000DDFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x308FFFFF, 0x000003FF, 0x03FFB800, 0xFFFFFFFF, 0xFFFFFFFF, 0x01FFFFFF,
+                    0xFFFFFFFF, 0xFFFF07FF, 0xFFFFFFFF, 0x003FFFFF, 0x7FFFFFFF, 0x0FFF0FFF,
+                    0xFFFFFFC0, 0x001F3FFF, 0xFFFFFFFF, 0xFFFF0FFF, 0x07FF03FF, 0x00000000,
+                    0x0FFFFFFF, 0xFFFFFFFF, 0x7FFFFFFF, 0x9FFFFFFF, 0x03FF03FF, 0xBFFF0080,
+                    0x00007FFF, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FF1FFF, 0x000FF800,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x000FFFFF, 0xFFFFFFFF, 0x00FFFFFF,
+                    0xFFFFE3FF, 0x3FFFFFFF, 0xFFFF01FF, 0xE7FFFFFF, 0xFFF70000, 0x07FFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x3F3FFFFF, 0xFFFFFFFF, 0xAAFF3F3F, 0x3FFFFFFF,
+                    0xFFFFFFFF, 0x5FDFFFFF, 0x0FCF1FDC, 0x1FDC1FFF, 0x00000000, 0x80000000,
+                    0x00100001, 0x80020000, 0x1FFF0000, 0x00000000, 0x1FFF0000, 0x0001FFE2,
+                    0x3F2FFC84, 0xF3FFFD50, 0x000043E0, 0xFFFFFFFF, 0x000001FF, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x000FF81F,
+                    0xFFFFFFFF, 0xFFFF20BF, 0xFFFFFFFF, 0x800080FF, 0x007FFFFF, 0x7F7F7F7F,
+                    0x7F7F7F7F, 0xFFFFFFFF, 0x000000E0, 0x1F3EFFFE, 0xFFFFFFFE, 0xFFFFFFFF,
+                    0xE67FFFFF, 0xFFFFFFFE, 0xFFFFFFFF, 0xF7FFFFFF, 0xFFFFFFE0, 0xFFFEFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x00007FFF, 0xFFFFFFFF, 0x00000000, 0xFFFF0000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x00001FFF, 0x00000000, 0xFFFF0000, 0x3FFFFFFF, 0xFFFF1FFF, 0x00000FFF,
+                    0xFFFFFFFF, 0xBFF0FFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x0003FFFF,
+                    0xFF800000, 0xFFFFFFFC, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFF9FF, 0xFFFFFFFF,
+                    0x03EB07FF, 0xFFFC0000, 0xFFFFFFFF, 0x000010FF, 0xFFFFFFFF, 0x000FFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x03FF003F, 0xE8FFFFFF, 0xFFFFFFFF, 0xFFFF3FFF,
+                    0x000FFFFF, 0x1FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FF8001, 0x7FFFFFFF,
+                    0xFFFFFFFF, 0x007FFFFF, 0x03FF3FFF, 0xFC7FFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x38000007, 0x007CFFFF, 0x007E7E7E, 0xFFFF7F7F, 0xF7FFFFFF, 0xFFFF03FF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FF37FF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF000F, 0xFFFFF87F, 0x0FFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF3FFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x03FFFFFF, 0x00000000, 0xE0F8007F, 0x5F7FFDFF, 0xFFFFFFDB, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x0003FFFF, 0xFFF80000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x3FFFFFFF, 0xFFFFFFF0, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x3FFFFFFF, 0xFFFF0000, 0xFFFFFFFF, 0xFFFCFFFF, 0xFFFFFFFF,
+                    0x000000FF, 0x03FF0000, 0x0000FFFF, 0x0018FFFF, 0x0000E000, 0xAA8A0000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x1FFFFFFF, 0x03FF0000, 0x87FFFFFE,
+                    0x07FFFFFE, 0xFFFFFFC0, 0xFFFFFFFF, 0x7FFFFFFF, 0x1CFCFCFC, 0x00000000,
+                    0xFFFFEFFF, 0xB7FFFF7F, 0x3FFF3FFF, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x07FFFFFF, 0x00000000, 0x00000000, 0xFFFFFFFF, 0x001FFFFF,
+                    0x00000000, 0x00000000, 0x00000000, 0x20000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x1FFFFFFF, 0xFFFFFFFF, 0x0001FFFF, 0x00000001,
+                    0xFFFFFFFF, 0xFFFFE000, 0xFFFF07FF, 0x07FFFFFF, 0x3FFFFFFF, 0xFFFFFFFF,
+                    0x003EFF0F, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x3FFFFFFF, 0xFFFF03FF, 0xFF0FFFFF, 0x0FFFFFFF, 0xFFFFFFFF, 0xFFFF00FF,
+                    0xFFFFFFFF, 0xF7FF000F, 0xFFB7F7FF, 0x1BFBFFFB, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0x007FFFFF, 0x003FFFFF, 0x000000FF, 0xFFFFFFBF, 0x07FDFFFF,
+                    0x00000000, 0x00000000, 0xFFFFFD3F, 0x91BFFFFF, 0x003FFFFF, 0x007FFFFF,
+                    0x7FFFFFFF, 0x00000000, 0x00000000, 0x0037FFFF, 0x003FFFFF, 0x03FFFFFF,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xC0FFFFFF, 0x00000000, 0x00000000,
+                    0xFEEFF06F, 0x873FFFFF, 0x00000000, 0x1FFFFFFF, 0x1FFFFFFF, 0x00000000,
+                    0xFFFFFEFF, 0x0000007F, 0xFFFFFFFF, 0x003FFFFF, 0x003FFFFF, 0x0007FFFF,
+                    0x0003FFFF, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x000001FF, 0x00000000, 0xFFFFFFFF, 0x0007FFFF, 0xFFFFFFFF, 0x0007FFFF,
+                    0xFFFFFFFF, 0x03FF00FF, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0x00031BFF, 0x00000000, 0x00000000, 0x1FFFFFFF, 0xFFFF0080,
+                    0x0001FFFF, 0xFFFF0000, 0x0000003F, 0xFFFF0000, 0x0000001F, 0x007FFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x0000007F, 0x803FFFC0, 0xFFFFFFFF, 0x07FFFFFF,
+                    0xFFFF0004, 0x03FF01FF, 0xFFFFFFFF, 0xFFDFFFFF, 0xFFFF00F0, 0x004FFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x17FFDE1F, 0x00000000, 0xFFFBFFFF, 0x40FFFFFF,
+                    0x00000000, 0x00000000, 0xBFFFBD7F, 0xFFFF01FF, 0xFFFFFFFF, 0x03FF07FF,
+                    0xFFF99FEF, 0xFBEDFDFF, 0xE081399F, 0x001F1FCF, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xC3FF07FF, 0x00000003,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x03FF00BF, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFF3FFFFF, 0x3F000001, 0x00000000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x03FF0011, 0x00000000, 0xFFFFFFFF, 0x01FFFFFF,
+                    0x000003FF, 0x00000000, 0xE7FFFFFF, 0x03FF0FFF, 0x0000007F, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0x07FFFFFF,
+                    0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x800003FF,
+                    0xFF6FF27F, 0xF9BFFFFF, 0x03FF000F, 0x00000000, 0x00000000, 0xFFFFFCFF,
+                    0xFCFFFFFF, 0x0000001B, 0xFFFFFFFF, 0x7FFFFFFF, 0xFFFF0080, 0xFFFFFFFF,
+                    0x23FFFFFF, 0xFFFF0000, 0xFFFFFFFF, 0x01FFFFFF, 0xFFFFFDFF, 0xFF7FFFFF,
+                    0x03FF0001, 0xFFFC0000, 0xFFFCFFFF, 0x007FFEFF, 0x00000000, 0x00000000,
+                    0xFFFFFB7F, 0xB47FFFFF, 0x03FF00FF, 0xFFFFFDBF, 0x01FB7FFF, 0x000003FF,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x007FFFFF, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00010000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FFFFFF, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00007FFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x0000000F, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFF0000, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x0001FFFF, 0xFFFFFFFF, 0x00007FFF, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x0000007F, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0x01FFFFFF, 0x7FFFFFFF, 0xFFFF03FF, 0xFFFFFFFF, 0x7FFFFFFF,
+                    0xFFFF03FF, 0x001F3FFF, 0xFFFFFFFF, 0x007FFFFF, 0x03FF000F, 0xE0FFFFF8,
+                    0x0000FFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFF87FF, 0xFFFFFFFF, 0xFFFF80FF, 0x00000000,
+                    0x00000000, 0x0003001B, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00FFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x003FFFFF, 0x00000000,
+                    0x000001FF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x6FEF0000, 0xFFFFFFFF, 0x00000007,
+                    0x00070000, 0xFFFF00F0, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0x0FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x1FFF07FF,
+                    0x63FF01FF, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFF3FFF,
+                    0x0000007F, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0xF807E3E0, 0x00000FE7, 0x00003C00,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0000001C, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFDFFFFF, 0xFFFFFFFF, 0xDFFFFFFF, 0xEBFFDE64, 0xFFFFFFEF, 0xFFFFFFFF,
+                    0xDFDFE7BF, 0x7BFFFFFF, 0xFFFDFC5F, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFF3F, 0xF7FFFFFD, 0xF7FFFFFF, 0xFFDFFFFF, 0xFFDFFFFF,
+                    0xFFFF7FFF, 0xFFFF7FFF, 0xFFFFFDFF, 0xFFFFFDFF, 0xFFFFCFF7, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xF87FFFFF, 0xFFFFFFFF, 0x00201FFF, 0xF8000010, 0x0000FFFE,
+                    0x00000000, 0x00000000, 0x7FFFFFFF, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xF9FFFF7F, 0x000007DB,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFFFFFF, 0x3FFF1FFF, 0x000043FF, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0xFFFF0000, 0x00007FFF, 0xFFFFFFFF, 0x03FFFFFF, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x7FFF6F7F,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x007F001F, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x03FF0FFF, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xFFFFFFEF, 0x0AF7FE96,
+                    0xAA96EA84, 0x5EF7F796, 0x0FFFFBFF, 0x0FFFFBEE, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x03FF0000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF, 0x01FFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0x3FFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFF0003, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000001,
+                    0x3FFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                    0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x000007FF, 0x00000000,
+                    0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                };
+            };
+
+            template <typename T>
+            constexpr std::uint8_t xid_tables<T>::stage1[];
+            template <typename T>
+            constexpr std::uint32_t xid_tables<T>::start[];
+            template <typename T>
+            constexpr std::uint32_t xid_tables<T>::continue_[];
+        } // namespace detail
+    } // namespace unicode
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_DETAIL_UNICODE_TABLES_HPP_INCLUDED
@@ -0,0 +1,152 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_LINE_INDEX_HPP_INCLUDED
+#define FOONATHAN_LEX_LINE_INDEX_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <foonathan/lex/detail/simd.hpp>
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    // a position in the input, both line and column start at one
+    struct line_column
+    {
+        std::size_t line;
+        std::size_t column;
+    };
+
+    class line_index
+    {
+    public:
+        enum class column_unit
+        {
+            bytes,
+            code_points, // UTF-8 code points
+        };
+
+        //=== constructors ===//
+        explicit line_index(const char* begin, const char* end,
+                            column_unit unit = column_unit::bytes)
+        : begin_(begin), end_(end), unit_(unit)
+        {
+            block_breaks_.push_back(0u);
+        }
+
+        template <class TokenSpec>
+        explicit line_index(const tokenizer<TokenSpec>& tokenizer,
+                            column_unit unit = column_unit::bytes)
+        : line_index(tokenizer.begin_ptr(), tokenizer.end_ptr(), unit)
+        {}
+
+        //=== lookup ===//
+        line_column location(std::size_t offset)
+        {
+            FOONATHAN_LEX_PRECONDITION(offset <= static_cast<std::size_t>(end_ - begin_),
+                                       "offset out of range");
+            auto block = offset / block_size;
+            index_until(block);
+
+            // the line breaks before the offset
+            auto breaks = break_mask(block) & ((std::uint64_t(1) << offset % block_size) - 1u);
+            auto line   = block_breaks_[block] + detail::popcount64(breaks) + 1u;
+
+            auto line_begin = std::size_t(0);
+            if (breaks != 0u)
+                line_begin = block * block_size + detail::bit_width64(breaks);
+            else if (block_breaks_[block] != 0u)
+            {
+                // the last block before it that contains a line break
+                auto first = block_breaks_.begin();
+                auto iter  = std::lower_bound(first, first + static_cast<std::ptrdiff_t>(block),
+                                             block_breaks_[block]);
+                auto last  = static_cast<std::size_t>(iter - first) - 1u;
+                line_begin = last * block_size + detail::bit_width64(break_mask(last));
+            }
+
+            if (unit_ == column_unit::bytes)
+                return {line, offset - line_begin + 1u};
+
+            // count all bytes that aren't continuation bytes
+            auto column = std::size_t(1);
+            for (auto cur = begin_ + line_begin; cur != begin_ + offset; ++cur)
+                if ((static_cast<unsigned char>(*cur) & 0xC0u) != 0x80u)
+                    ++column;
+            return {line, column};
+        }
+
+        line_column location(const char* position)
+        {
+            return location(static_cast<std::size_t>(position - begin_));
+        }
+
+        template <class TokenSpec>
+        line_column location(const token<TokenSpec>& token)
+        {
+            return location(token.spelling().data());
+        }
+
+    private:
+        static constexpr std::size_t block_size = 64;
+
+        // mask of the characters in the block that are line breaks, i.e. "\n",
+        // or "\r" if it isn't followed by "\n"
+        std::uint64_t break_mask(std::size_t block) const noexcept
+        {
+            auto cur = begin_ + block * block_size;
+
+            auto newlines = std::uint64_t(0);
+            auto returns  = std::uint64_t(0);
+            if (static_cast<std::size_t>(end_ - cur) >= block_size)
+            {
+                newlines = detail::block_char_mask(cur, '\n');
+                returns  = detail::block_char_mask(cur, '\r');
+            }
+            else
+            {
+                for (auto i = 0u; cur + i != end_; ++i)
+                    if (cur[i] == '\n')
+                        newlines |= std::uint64_t(1) << i;
+                    else if (cur[i] == '\r')
+                        returns |= std::uint64_t(1) << i;
+            }
+            if (returns == 0u)
+                return newlines;
+
+            auto next = cur + block_size;
+            auto newline_after_block
+                = static_cast<std::size_t>(end_ - cur) > block_size && *next == '\n';
+            auto next_newlines = newlines >> 1 | std::uint64_t(newline_after_block) << 63;
+            return newlines | (returns & ~next_newlines);
+        }
+
+        // ensures that the line breaks before the block are counted
+        void index_until(std::size_t block)
+        {
+            for (auto cur = block_breaks_.size() - 1u; cur < block; ++cur)
+            {
+                auto breaks = detail::popcount64(break_mask(cur));
+                block_breaks_.push_back(block_breaks_.back() + breaks);
+            }
+        }
+
+        const char* begin_;
+        const char* end_;
+        column_unit unit_;
+
+        // the number of line breaks before each block of `block_size` characters,
+        // for all blocks that have been indexed so far
+        std::vector<std::size_t> block_breaks_;
+    };
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_LINE_INDEX_HPP_INCLUDED
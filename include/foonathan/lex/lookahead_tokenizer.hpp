@@ -0,0 +1,167 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_LOOKAHEAD_TOKENIZER_HPP_INCLUDED
+#define FOONATHAN_LEX_LOOKAHEAD_TOKENIZER_HPP_INCLUDED
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    template <class TokenSpec, std::size_t Capacity = 16>
+    class lookahead_tokenizer
+    {
+        using matcher = detail::token_spec_matcher<TokenSpec>;
+        static_assert(Capacity > 1u && (Capacity & (Capacity - 1u)) == 0u,
+                      "capacity must be a power of two");
+
+    public:
+        static constexpr std::size_t max_lookahead = Capacity - 1u;
+
+        //=== constructors ===//
+        explicit constexpr lookahead_tokenizer(const char* ptr, std::size_t size) noexcept
+        : lookahead_tokenizer(ptr, ptr + size)
+        {}
+
+        explicit constexpr lookahead_tokenizer(const char* begin, const char* end)
+        : begin_(begin), end_(end)
+        {
+            FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                       "input must be null terminated");
+            reset(begin);
+        }
+
+        template <std::size_t N>
+        explicit constexpr lookahead_tokenizer(const char (&array)[N])
+        : lookahead_tokenizer(array, array + N - 1)
+        {}
+
+        //=== tokenizer functions ===//
+        constexpr token<TokenSpec> peek() const noexcept
+        {
+            return buffer_[cur_ & mask];
+        }
+
+        // returns the token `n` tokens after the current one
+        constexpr token<TokenSpec> peek(std::size_t n) noexcept
+        {
+            FOONATHAN_LEX_PRECONDITION(n <= max_lookahead, "lookahead too big");
+            fill(cur_ + n);
+            return buffer_[(cur_ + n) & mask];
+        }
+
+        template <std::size_t N>
+        constexpr token<TokenSpec> peek() noexcept
+        {
+            static_assert(N <= max_lookahead, "lookahead too big");
+            return peek(N);
+        }
+
+        constexpr bool is_done() const noexcept
+        {
+            FOONATHAN_LEX_ASSERT(peek().spelling().size() != 0 || peek().is(eof_token{}));
+            return peek().spelling().size() == 0;
+        }
+
+        constexpr token<TokenSpec> get() noexcept
+        {
+            auto result = peek();
+            bump();
+            return result;
+        }
+
+        constexpr void bump() noexcept
+        {
+            if (!is_done())
+            {
+                ++cur_;
+                fill(cur_);
+            }
+        }
+
+        constexpr void reset(const char* position) noexcept
+        {
+            FOONATHAN_LEX_PRECONDITION(begin_ <= position && position <= end_,
+                                       "position out of range");
+
+            // tokens that are still buffered don't need to be matched again
+            for (auto i = head_; i != tail_; ++i)
+                if (buffer_[i & mask].spelling().data() == position)
+                {
+                    cur_ = i;
+                    return;
+                }
+
+            head_ = cur_ = tail_ = 0;
+            next_                = position;
+            fill(0);
+        }
+
+        //=== getters ===//
+        constexpr const char* begin_ptr() const noexcept
+        {
+            return begin_;
+        }
+
+        constexpr const char* current_ptr() const noexcept
+        {
+            return peek().spelling().data();
+        }
+
+        constexpr const char* end_ptr() const noexcept
+        {
+            return end_;
+        }
+
+    private:
+        static constexpr std::size_t mask = Capacity - 1u;
+
+        // ensures that the token with the given index is buffered
+        constexpr void fill(std::size_t index) noexcept
+        {
+            while (tail_ <= index)
+            {
+                if (tail_ - head_ == Capacity)
+                    // discard the oldest token, which can't be reset to cheaply anymore
+                    ++head_;
+                FOONATHAN_LEX_ASSERT(head_ <= cur_);
+
+                auto trivia_begin = next_;
+                auto result       = matcher::try_match(next_, end_);
+                while (result.kind.template is_category<is_whitespace_token>())
+                {
+                    next_ += result.bump;
+                    result = matcher::try_match(next_, end_);
+                }
+
+                buffer_[tail_ & mask]
+                    = detail::token_factory::make(result.kind, next_, result.bump,
+                                                  static_cast<std::size_t>(next_ - trivia_begin));
+                next_ += result.bump;
+                ++tail_;
+            }
+        }
+
+        const char* begin_{};
+        const char* end_{};
+        // where the next token is matched
+        const char* next_{};
+
+        // the buffered tokens have indices [head_, tail_), stored at `index & mask`
+        token<TokenSpec> buffer_[Capacity]{};
+        std::size_t      head_{};
+        std::size_t      cur_{};
+        std::size_t      tail_{};
+    };
+
+    template <class TokenSpec, std::size_t Capacity>
+    constexpr std::size_t lookahead_tokenizer<TokenSpec, Capacity>::max_lookahead;
+    template <class TokenSpec, std::size_t Capacity>
+    constexpr std::size_t lookahead_tokenizer<TokenSpec, Capacity>::mask;
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_LOOKAHEAD_TOKENIZER_HPP_INCLUDED
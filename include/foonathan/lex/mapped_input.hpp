@@ -0,0 +1,232 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_MAPPED_INPUT_HPP_INCLUDED
+#define FOONATHAN_LEX_MAPPED_INPUT_HPP_INCLUDED
+
+// whether or not files are mapped into memory,
+// otherwise they are read into a buffer
+#ifndef FOONATHAN_LEX_HAS_MMAP
+#    if defined(__unix__) || defined(__APPLE__)
+#        define FOONATHAN_LEX_HAS_MMAP 1
+#    else
+#        define FOONATHAN_LEX_HAS_MMAP 0
+#    endif
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <utility>
+
+#if FOONATHAN_LEX_HAS_MMAP
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#else
+#    include <cstdio>
+#    include <memory>
+#    include <new>
+#endif
+
+namespace foonathan
+{
+namespace lex
+{
+    class mapped_input
+    {
+    public:
+        //=== constructors ===//
+        mapped_input() noexcept = default;
+
+        explicit mapped_input(const char* path) noexcept
+        {
+#if FOONATHAN_LEX_HAS_MMAP
+            auto fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd == -1)
+            {
+                error_ = errno;
+                return;
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0)
+                error_ = errno;
+            else if (!S_ISREG(info.st_mode))
+                // pipes and devices don't have a size that can be mapped
+                error_ = ENODEV;
+            else
+                map(fd, static_cast<std::size_t>(info.st_size));
+
+            ::close(fd);
+#else
+            read(path);
+#endif
+        }
+
+        mapped_input(mapped_input&& other) noexcept
+        : begin_(other.begin_), size_(other.size_), error_(other.error_),
+#if FOONATHAN_LEX_HAS_MMAP
+          mapping_size_(other.mapping_size_)
+#else
+          buffer_(std::move(other.buffer_))
+#endif
+        {
+            other.begin_ = nullptr;
+            other.size_  = 0;
+        }
+
+        ~mapped_input() noexcept
+        {
+#if FOONATHAN_LEX_HAS_MMAP
+            if (begin_)
+                ::munmap(const_cast<char*>(begin_), mapping_size_);
+#endif
+        }
+
+        mapped_input& operator=(mapped_input&& other) noexcept
+        {
+            mapped_input tmp(std::move(other));
+            swap(*this, tmp);
+            return *this;
+        }
+
+        friend void swap(mapped_input& lhs, mapped_input& rhs) noexcept
+        {
+            using std::swap;
+            swap(lhs.begin_, rhs.begin_);
+            swap(lhs.size_, rhs.size_);
+            swap(lhs.error_, rhs.error_);
+#if FOONATHAN_LEX_HAS_MMAP
+            swap(lhs.mapping_size_, rhs.mapping_size_);
+#else
+            swap(lhs.buffer_, rhs.buffer_);
+#endif
+        }
+
+        //=== access ===//
+        explicit operator bool() const noexcept
+        {
+            return begin_ != nullptr;
+        }
+
+        // the `errno` value if the file couldn't be opened, zero otherwise
+        int error() const noexcept
+        {
+            return error_;
+        }
+
+        // the input is followed by at least one page of null characters
+        const char* begin() const noexcept
+        {
+            return begin_;
+        }
+
+        const char* end() const noexcept
+        {
+            return begin_ + size_;
+        }
+
+        const char* data() const noexcept
+        {
+            return begin_;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+    private:
+        static std::size_t page_size() noexcept
+        {
+#if FOONATHAN_LEX_HAS_MMAP
+            return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else
+            return 4096u;
+#endif
+        }
+
+#if FOONATHAN_LEX_HAS_MMAP
+        void map(int fd, std::size_t size) noexcept
+        {
+            // reserve the file rounded up to whole pages followed by a page of zeros,
+            // then map the file over the beginning
+            auto page         = page_size();
+            auto mapping_size = (size + page - 1u) / page * page + page;
+            auto mapping
+                = ::mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapping == MAP_FAILED)
+            {
+                error_ = errno;
+                return;
+            }
+
+            if (size > 0u)
+            {
+                auto file = ::mmap(mapping, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+                if (file == MAP_FAILED)
+                {
+                    error_ = errno;
+                    ::munmap(mapping, mapping_size);
+                    return;
+                }
+
+                // only a hint, so errors are ignored
+                ::madvise(mapping, size, MADV_SEQUENTIAL);
+            }
+
+            begin_        = static_cast<const char*>(mapping);
+            size_         = size;
+            mapping_size_ = mapping_size;
+        }
+#else
+        void read(const char* path) noexcept
+        {
+            auto file = std::fopen(path, "rb");
+            if (!file)
+            {
+                error_ = errno;
+                return;
+            }
+
+            auto size = std::fseek(file, 0, SEEK_END) == 0 ? std::ftell(file) : -1;
+            if (size >= 0)
+            {
+                std::rewind(file);
+
+                // value-initialization fills the trailing page with zeros
+                auto                    count = static_cast<std::size_t>(size);
+                std::unique_ptr<char[]> buffer(new (std::nothrow) char[count + page_size()]());
+                if (!buffer)
+                    error_ = ENOMEM;
+                else if (std::fread(buffer.get(), 1, count, file) != count)
+                    error_ = EIO;
+                else
+                {
+                    buffer_ = std::move(buffer);
+                    begin_  = buffer_.get();
+                    size_   = count;
+                }
+            }
+            else
+                error_ = errno;
+
+            std::fclose(file);
+        }
+#endif
+
+        const char* begin_ = nullptr;
+        std::size_t size_  = 0;
+        int         error_ = 0;
+#if FOONATHAN_LEX_HAS_MMAP
+        std::size_t mapping_size_ = 0;
+#else
+        std::unique_ptr<char[]> buffer_;
+#endif
+    };
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_MAPPED_INPUT_HPP_INCLUDED
@@ -0,0 +1,252 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_MODAL_TOKENIZER_HPP_INCLUDED
+#define FOONATHAN_LEX_MODAL_TOKENIZER_HPP_INCLUDED
+
+#include <type_traits>
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    // the tokens that are matched in a mode of the `modal_tokenizer`
+    template <class... Tokens>
+    struct token_mode
+    {
+        using list = boost::mp11::mp_list<Tokens...>;
+    };
+
+    namespace detail
+    {
+        struct push_mode_base
+        {};
+    } // namespace detail
+
+    // a token that enters the given mode after it was matched
+    template <class Mode>
+    struct push_mode : detail::push_mode_base
+    {
+        using pushed_mode = Mode;
+    };
+
+    template <class Token>
+    struct is_push_mode_token : std::is_base_of<detail::push_mode_base, Token>
+    {};
+
+    // a token that returns to the previous mode after it was matched
+    struct pop_mode
+    {};
+
+    template <class Token>
+    struct is_pop_mode_token : std::is_base_of<pop_mode, Token>
+    {};
+
+    namespace detail
+    {
+        //=== mode actions ===//
+        // 0 means no mode change, 1 pop, and 2 + i push of the mode with index i
+        template <class ModeList, class Token>
+        constexpr unsigned char mode_action(std::true_type /* push */, std::false_type) noexcept
+        {
+            using mode = typename Token::pushed_mode;
+            static_assert(mp::mp_contains<ModeList, mode>::value, "pushed mode isn't a mode");
+            return static_cast<unsigned char>(2u + mp::mp_find<ModeList, mode>::value);
+        }
+        template <class ModeList, class Token>
+        constexpr unsigned char mode_action(std::false_type, std::true_type /* pop */) noexcept
+        {
+            return 1u;
+        }
+        template <class ModeList, class Token>
+        constexpr unsigned char mode_action(std::false_type, std::false_type) noexcept
+        {
+            return 0u;
+        }
+
+        template <class ModeList, class TokenList>
+        struct mode_action_table;
+        template <class ModeList, class... Tokens>
+        struct mode_action_table<ModeList, mp::mp_list<Tokens...>>
+        {
+            static constexpr unsigned char value[]
+                = {mode_action<ModeList, Tokens>(is_push_mode_token<Tokens>{},
+                                                 is_pop_mode_token<Tokens>{})...};
+        };
+
+        template <class ModeList, class... Tokens>
+        constexpr unsigned char mode_action_table<ModeList, mp::mp_list<Tokens...>>::value[];
+
+        //=== mode_matcher ===//
+        // matches a single token using the trie of the mode with the given index
+        template <class TokenSpec, class ModeList>
+        struct mode_matcher;
+        template <class TokenSpec, class Head, class... Tail>
+        struct mode_matcher<TokenSpec, mp::mp_list<Head, Tail...>>
+        {
+            static constexpr match_result<TokenSpec> try_match(std::size_t mode, const char* str,
+                                                               const char* end) noexcept
+            {
+                if (mode == 0u)
+                    return token_spec_matcher<TokenSpec, typename Head::list>::try_match(str, end);
+                else
+                    return mode_matcher<TokenSpec, mp::mp_list<Tail...>>::try_match(mode - 1u,
+                                                                                    str, end);
+            }
+        };
+        template <class TokenSpec>
+        struct mode_matcher<TokenSpec, mp::mp_list<>>
+        {
+            static constexpr match_result<TokenSpec> try_match(std::size_t, const char*,
+                                                               const char*) noexcept
+            {
+                FOONATHAN_LEX_ASSERT(false);
+                return match_result<TokenSpec>::error(1);
+            }
+        };
+    } // namespace detail
+
+    template <class TokenSpec, class... Modes>
+    class modal_tokenizer
+    {
+        using modes            = detail::mp::mp_list<Modes...>;
+        using matcher          = detail::mode_matcher<TokenSpec, modes>;
+        using trivia_begin_ptr = detail::trivia_begin<detail::preserve_trivia<TokenSpec>::value>;
+        static_assert(detail::mp::mp_all_of<typename TokenSpec::list, is_token>::value,
+                      "invalid types in token specifications");
+        static_assert(sizeof...(Modes) > 0u && sizeof...(Modes) < 255u,
+                      "invalid number of modes");
+
+    public:
+        static constexpr std::size_t max_mode_depth = 32;
+
+        //=== constructors ===//
+        explicit constexpr modal_tokenizer(const char* ptr, std::size_t size) noexcept
+        : modal_tokenizer(ptr, ptr + size)
+        {}
+
+        explicit constexpr modal_tokenizer(const char* begin, const char* end)
+        : begin_(begin),
+          ptr_(begin),
+          end_(end),
+          trivia_begin_(begin),
+          last_result_(match_result<TokenSpec>::unmatched())
+        {
+            FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                       "input must be null terminated");
+            bump();
+        }
+
+        template <std::size_t N>
+        explicit constexpr modal_tokenizer(const char (&array)[N])
+        : modal_tokenizer(array, array + N - 1)
+        {}
+
+        //=== tokenizer functions ===//
+        constexpr token<TokenSpec> peek() const noexcept
+        {
+            return detail::token_factory::make(last_result_.kind, ptr_, last_result_.bump,
+                                               trivia_begin_.size(ptr_));
+        }
+
+        constexpr bool is_done() const noexcept
+        {
+            FOONATHAN_LEX_ASSERT(last_result_.bump != 0 || peek().is(eof_token{}));
+            return last_result_.bump == 0;
+        }
+
+        constexpr token<TokenSpec> get() noexcept
+        {
+            auto result = peek();
+            bump();
+            return result;
+        }
+
+        constexpr void bump() noexcept
+        {
+            auto position = ptr_ + last_result_.bump;
+            trivia_begin_.set(position);
+            match(position);
+            while (last_result_.kind.template is_category<is_whitespace_token>())
+                match(ptr_ + last_result_.bump);
+        }
+
+        //=== getters ===//
+        constexpr const char* begin_ptr() const noexcept
+        {
+            return begin_;
+        }
+
+        constexpr const char* current_ptr() const noexcept
+        {
+            FOONATHAN_LEX_ASSERT(peek().spelling().data() == ptr_);
+            return ptr_;
+        }
+
+        constexpr const char* end_ptr() const noexcept
+        {
+            return end_;
+        }
+
+        // whether the current token was matched in the given mode
+        template <class Mode>
+        constexpr bool is_mode(Mode = {}) const noexcept
+        {
+            static_assert(detail::mp::mp_contains<modes, Mode>::value, "not one of the modes");
+            return mode_ == detail::mp::mp_find<modes, Mode>::value;
+        }
+
+        // the number of modes that have been pushed and not popped yet
+        constexpr std::size_t mode_depth() const noexcept
+        {
+            return depth_;
+        }
+
+    private:
+        constexpr void match(const char* position) noexcept
+        {
+            ptr_         = position;
+            mode_        = stack_[depth_];
+            last_result_ = matcher::try_match(mode_, ptr_, end_);
+
+            using actions = detail::mode_action_table<modes, typename TokenSpec::list>;
+            auto action   = actions::value[last_result_.kind.get()];
+            if (action == 1u)
+            {
+                // popping the initial mode does nothing
+                if (depth_ > 0u)
+                    --depth_;
+            }
+            else if (action > 1u)
+            {
+                if (depth_ + 1u == max_mode_depth)
+                    // the stack is full, so the token is an error and the mode stays the same
+                    last_result_ = match_result<TokenSpec>::error(last_result_.bump);
+                else
+                    stack_[++depth_] = static_cast<unsigned char>(action - 2u);
+            }
+        }
+
+        const char*      begin_{};
+        const char*      ptr_{};
+        const char*      end_{};
+        trivia_begin_ptr trivia_begin_;
+
+        match_result<TokenSpec> last_result_;
+
+        // `stack_[depth_]` is the mode the next token is matched in,
+        // `mode_` the one the current token was matched in
+        unsigned char stack_[max_mode_depth]{};
+        std::size_t   depth_{};
+        unsigned char mode_{};
+    };
+
+    template <class TokenSpec, class... Modes>
+    constexpr std::size_t modal_tokenizer<TokenSpec, Modes...>::max_mode_depth;
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_MODAL_TOKENIZER_HPP_INCLUDED
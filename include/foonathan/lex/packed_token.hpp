@@ -0,0 +1,181 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_PACKED_TOKEN_HPP_INCLUDED
+#define FOONATHAN_LEX_PACKED_TOKEN_HPP_INCLUDED
+
+#include <cstdint>
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace detail
+    {
+        // the number of characters of the trivia before a packed token,
+        // only stored if trivia is preserved, it fits as it is at most the offset
+        template <bool Preserve>
+        class packed_trivia_size
+        {
+        protected:
+            explicit constexpr packed_trivia_size(std::size_t) noexcept {}
+
+            constexpr std::size_t trivia_size() const noexcept
+            {
+                return 0;
+            }
+        };
+
+        template <>
+        class packed_trivia_size<true>
+        {
+        protected:
+            explicit constexpr packed_trivia_size(std::size_t size) noexcept
+            : size_(static_cast<std::uint32_t>(size))
+            {}
+
+            constexpr std::size_t trivia_size() const noexcept
+            {
+                return size_;
+            }
+
+        private:
+            std::uint32_t size_;
+        };
+    } // namespace detail
+
+    // inherits the trivia size, so it doesn't take up space unless trivia is preserved
+    template <class TokenSpec>
+    class packed_token : detail::packed_trivia_size<detail::preserve_trivia<TokenSpec>::value>
+    {
+        using trivia_base = detail::packed_trivia_size<detail::preserve_trivia<TokenSpec>::value>;
+        using id_type     = token_kind_detail::id_type<TokenSpec>;
+        static_assert(sizeof(id_type) <= 2u, "too many tokens to pack");
+
+        // the kind is stored in the lower bits, the length in the upper bits
+        static constexpr auto kind_bits       = sizeof(id_type) * 8u;
+        static constexpr auto kind_mask       = (std::uint32_t(1) << kind_bits) - 1u;
+        static constexpr auto length_overflow = std::uint32_t(0xFFFFFFFFu) >> kind_bits;
+
+    public:
+        // the maximal length that is stored directly, longer tokens are re-tokenized on unpacking
+        static constexpr std::size_t max_packed_length = length_overflow - 1u;
+
+        constexpr packed_token() noexcept : trivia_base(0), offset_(0), length_kind_(0) {}
+
+        explicit constexpr packed_token(const tokenizer<TokenSpec>& tokenizer,
+                                        const token<TokenSpec>&     token) noexcept
+        : packed_token(tokenizer.begin_ptr(), token)
+        {}
+
+        explicit constexpr packed_token(const char* begin, const token<TokenSpec>& token) noexcept
+        : trivia_base(token.leading_trivia().size()),
+          offset_(static_cast<std::uint32_t>(token.spelling().data() - begin)),
+          length_kind_(pack(token.spelling().size(), token.kind()))
+        {
+            FOONATHAN_LEX_PRECONDITION(static_cast<std::uint64_t>(token.spelling().data() - begin)
+                                           <= UINT32_MAX,
+                                       "offset too big for 32bit");
+        }
+
+        //=== access ===//
+        constexpr token_kind<TokenSpec> kind() const noexcept
+        {
+            return token_kind<TokenSpec>::from_id(length_kind_ & kind_mask);
+        }
+
+        explicit constexpr operator bool() const noexcept
+        {
+            return !!kind();
+        }
+
+        template <class Token>
+        constexpr bool is(Token token = {}) const noexcept
+        {
+            return kind().is(token);
+        }
+
+        template <template <typename> class Category>
+        constexpr bool is_category() const noexcept
+        {
+            return kind().template is_category<Category>();
+        }
+
+        constexpr const char* name() const noexcept
+        {
+            return kind().name();
+        }
+
+        constexpr std::size_t offset() const noexcept
+        {
+            return offset_;
+        }
+
+        constexpr bool is_length_overflow() const noexcept
+        {
+            return (length_kind_ >> kind_bits) == length_overflow;
+        }
+
+        //=== unpacking ===//
+        constexpr token_spelling spelling(const tokenizer<TokenSpec>& tokenizer) const noexcept
+        {
+            return spelling(tokenizer.begin_ptr(), tokenizer.end_ptr());
+        }
+
+        constexpr token_spelling spelling(const char* begin, const char* end) const noexcept
+        {
+            return token_spelling(begin + offset_, length(begin, end));
+        }
+
+        constexpr token<TokenSpec> unpack(const tokenizer<TokenSpec>& tokenizer) const noexcept
+        {
+            return unpack(tokenizer.begin_ptr(), tokenizer.end_ptr());
+        }
+
+        constexpr token<TokenSpec> unpack(const char* begin, const char* end) const noexcept
+        {
+            return detail::token_factory::make(kind(), begin + offset_, length(begin, end),
+                                               this->trivia_size());
+        }
+
+        friend constexpr bool operator==(packed_token lhs, packed_token rhs) noexcept
+        {
+            return lhs.offset_ == rhs.offset_ && lhs.length_kind_ == rhs.length_kind_
+                   && lhs.trivia_size() == rhs.trivia_size();
+        }
+        friend constexpr bool operator!=(packed_token lhs, packed_token rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        static constexpr std::uint32_t pack(std::size_t length, token_kind<TokenSpec> kind) noexcept
+        {
+            auto packed_length = length <= max_packed_length ? static_cast<std::uint32_t>(length)
+                                                             : length_overflow;
+            return (packed_length << kind_bits) | kind.get();
+        }
+
+        constexpr std::size_t length(const char* begin, const char* end) const noexcept
+        {
+            if (!is_length_overflow())
+                return length_kind_ >> kind_bits;
+
+            // tokenizing is deterministic, so the same token is matched again,
+            // unless it was matched by something other than the token spec, like a mode
+            auto result = detail::token_spec_matcher<TokenSpec>::try_match(begin + offset_, end);
+            FOONATHAN_LEX_PRECONDITION(result.kind == kind() && result.bump > max_packed_length,
+                                       "token with overflowing length can't be matched again");
+            return result.bump;
+        }
+
+        std::uint32_t offset_;
+        std::uint32_t length_kind_;
+    };
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_PACKED_TOKEN_HPP_INCLUDED
@@ -0,0 +1,151 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_PARALLEL_TOKENIZE_HPP_INCLUDED
+#define FOONATHAN_LEX_PARALLEL_TOKENIZE_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <foonathan/lex/token_buffer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace detail
+    {
+        // inputs smaller than that per thread aren't worth splitting
+        constexpr std::size_t min_parallel_chunk_size = 64 * 1024u;
+
+        // returns the beginning of the line after `ptr`, or `ptr` if there is none before `limit`
+        inline const char* next_line(const char* ptr, const char* limit) noexcept
+        {
+            auto newline = static_cast<const char*>(
+                std::memchr(ptr, '\n', static_cast<std::size_t>(limit - ptr)));
+            return newline ? newline + 1 : ptr;
+        }
+
+        // splits the input into `chunk_count` chunks, chunk i is [starts[i], starts[i + 1]),
+        // chunks start at the beginning of a line as that is most likely the beginning of a token
+        inline std::vector<const char*> split_lines(const char* begin, const char* end,
+                                                    std::size_t chunk_count)
+        {
+            std::vector<const char*> starts(chunk_count + 1u);
+            starts.front() = begin;
+            starts.back()  = end;
+
+            auto chunk_size = static_cast<std::size_t>(end - begin) / chunk_count;
+            for (auto i = std::size_t(1); i != chunk_count; ++i)
+            {
+                auto split = begin + i * chunk_size;
+                starts[i]  = next_line(split, split + chunk_size / 2u);
+            }
+
+            return starts;
+        }
+
+        // tokenizes the chunk [start, stop) speculatively,
+        // returns where the last token ends
+        template <class TokenSpec>
+        const char* tokenize_chunk(const char* begin, const char* start, const char* stop,
+                                   const char* end, token_buffer<TokenSpec>& result)
+        {
+            result.start(begin, start);
+            return result.append_tokens(start, stop, end);
+        }
+
+        // stitches the chunks 1 to n - 1 to the tokens of chunk 0 in `buffer`:
+        // tokenize from the end of the previous chunk until a token ends where a speculative token
+        // begins, as tokenizing is deterministic, the speculative tokens are correct from there on,
+        // if the chunk started inside a comment, say, all tokens up to the resync point are redone
+        template <class TokenSpec>
+        void stitch_chunks(const char* begin, const char* end, token_buffer<TokenSpec>& buffer,
+                           const std::vector<const char*>& starts,
+                           const std::vector<const char*>& stops,
+                           const token_buffer<TokenSpec>*  chunks)
+        {
+            auto chunk_count = stops.size();
+            auto cur         = stops[0];
+            for (auto i = std::size_t(1); i != chunk_count; ++i)
+            {
+                if (cur < starts[i])
+                    // the previous chunk reached the end of the input
+                    break;
+
+                auto& chunk   = chunks[i];
+                auto  offsets = chunk.offsets();
+                auto  first   = offsets;
+                while (true)
+                {
+                    first = std::lower_bound(first, offsets + chunk.size(),
+                                             static_cast<std::uint32_t>(cur - begin));
+                    if (first == offsets + chunk.size())
+                    {
+                        // no resync point left, tokenize the rest of the chunk again
+                        cur = buffer.append_tokens(cur, starts[i + 1], end);
+                        break;
+                    }
+
+                    auto next = begin + *first;
+                    cur       = buffer.append_tokens(cur, next, end);
+                    if (cur == next)
+                    {
+                        auto index = static_cast<std::size_t>(first - offsets);
+                        buffer.append(chunk, index, chunk.size(), 0);
+                        cur = stops[i];
+                        break;
+                    }
+                    else if (cur < next)
+                        // end of the input
+                        break;
+                }
+            }
+        }
+    } // namespace detail
+
+    template <class TokenSpec>
+    void tokenize_all(const char* begin, const char* end, token_buffer<TokenSpec>& buffer,
+                      unsigned thread_count)
+    {
+        FOONATHAN_LEX_PRECONDITION(static_cast<std::uint64_t>(end - begin) <= UINT32_MAX,
+                                   "input too big for 32bit offsets");
+        FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                   "input must be null terminated");
+
+        auto size        = static_cast<std::size_t>(end - begin);
+        auto chunk_count = std::min(std::size_t(thread_count == 0u ? 1u : thread_count),
+                                    size / detail::min_parallel_chunk_size);
+        if (chunk_count <= 1u)
+        {
+            tokenize_all(begin, end, buffer);
+            return;
+        }
+
+        auto starts = detail::split_lines(begin, end, chunk_count);
+
+        // tokenize all chunks speculatively,
+        // the first chunk directly into the buffer as its start is known to be correct
+        std::vector<token_buffer<TokenSpec>> chunks(chunk_count);
+        std::vector<const char*>             stops(chunk_count);
+        auto tokenize_chunk = [&](std::size_t i, token_buffer<TokenSpec>& result) {
+            stops[i] = detail::tokenize_chunk(begin, starts[i], starts[i + 1], end, result);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(chunk_count - 1u);
+        for (auto i = std::size_t(1); i != chunk_count; ++i)
+            threads.emplace_back(tokenize_chunk, i, std::ref(chunks[i]));
+        tokenize_chunk(0, buffer);
+        for (auto& thread : threads)
+            thread.join();
+
+        detail::stitch_chunks(begin, end, buffer, starts, stops, chunks.data());
+    }
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_PARALLEL_TOKENIZE_HPP_INCLUDED
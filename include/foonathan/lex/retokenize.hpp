@@ -0,0 +1,125 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_RETOKENIZE_HPP_INCLUDED
+#define FOONATHAN_LEX_RETOKENIZE_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+
+#include <foonathan/lex/token_buffer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    // replaces `old_length` characters starting at `offset` with `new_length` characters
+    struct text_edit
+    {
+        std::size_t offset;
+        std::size_t old_length;
+        std::size_t new_length;
+    };
+
+    // replaces `old_count` tokens starting at index `first` with `new_count` tokens,
+    // the offsets of the tokens after them change by `shift`
+    struct token_splice
+    {
+        std::size_t    first;
+        std::size_t    old_count;
+        std::size_t    new_count;
+        std::ptrdiff_t shift;
+    };
+
+    template <class TokenSpec>
+    token_splice retokenize(const token_buffer<TokenSpec>& old_tokens, const char* begin,
+                            const char* end, text_edit edit, token_buffer<TokenSpec>& new_tokens,
+                            std::size_t lookbehind = 1)
+    {
+        FOONATHAN_LEX_PRECONDITION(static_cast<std::uint64_t>(end - begin) <= UINT32_MAX,
+                                   "input too big for 32bit offsets");
+        FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                   "input must be null terminated");
+        FOONATHAN_LEX_PRECONDITION(edit.offset + edit.new_length
+                                       <= static_cast<std::size_t>(end - begin),
+                                   "edit out of range");
+
+        auto offsets = old_tokens.offsets();
+        auto size    = old_tokens.size();
+        auto shift   = static_cast<std::ptrdiff_t>(edit.new_length)
+                     - static_cast<std::ptrdiff_t>(edit.old_length);
+
+        // tokenize again starting with the last token that starts before the edit,
+        // as it might be extended by it, and `lookbehind` tokens before that,
+        // whose match might have depended on characters after their end
+        auto affected = static_cast<std::size_t>(
+            std::lower_bound(offsets, offsets + size, edit.offset) - offsets);
+        auto first = affected > lookbehind ? affected - 1u - lookbehind : std::size_t(0);
+        auto cur   = first == 0u ? begin : begin + offsets[first];
+
+        // the trivia of the first new token begins where the token before it ends
+        auto trivia_begin
+            = first == 0u ? begin : begin + offsets[first - 1u] + old_tokens.length(first - 1u);
+        new_tokens.start(begin, trivia_begin);
+
+        // all tokens up to the end of the edit can change
+        auto edit_end = begin + edit.offset + edit.new_length;
+        cur           = new_tokens.append_tokens(cur, edit_end, end);
+
+        // afterwards, the input is the same as before, only shifted,
+        // so once a token begins where an old token begins, all following tokens are the same
+        auto last = size;
+        if (cur >= edit_end)
+        {
+            auto old_token = offsets;
+            while (true)
+            {
+                old_token = std::lower_bound(old_token, offsets + size,
+                                             static_cast<std::uint32_t>(cur - begin - shift));
+                if (old_token == offsets + size)
+                {
+                    // no old token left to realign with
+                    new_tokens.append_tokens(cur, end, end);
+                    break;
+                }
+
+                auto next = begin + *old_token + shift;
+                cur       = new_tokens.append_tokens(cur, next, end);
+                if (cur == next)
+                {
+                    last = static_cast<std::size_t>(old_token - offsets);
+                    break;
+                }
+                else if (cur < next)
+                    // end of the input
+                    break;
+            }
+        }
+
+        return token_splice{first, last - first, new_tokens.size(), shift};
+    }
+
+    template <class TokenSpec>
+    void apply_splice(token_buffer<TokenSpec>& tokens, const token_splice& splice,
+                      const token_buffer<TokenSpec>& new_tokens)
+    {
+        FOONATHAN_LEX_PRECONDITION(splice.first + splice.old_count <= tokens.size()
+                                       && splice.new_count == new_tokens.size(),
+                                   "splice doesn't match the tokens");
+
+        token_buffer<TokenSpec> result;
+        result.reserve(tokens.size() - splice.old_count + splice.new_count);
+        result.begin_ = new_tokens.begin_;
+        // the first token is one of the new tokens if the splice starts at the beginning
+        result.start_ = splice.first == 0u && splice.new_count != 0u ? new_tokens.start_
+                                                                     : tokens.start_;
+        result.append(tokens, 0, splice.first, 0);
+        result.append(new_tokens, 0, splice.new_count, 0);
+        result.append(tokens, splice.first + splice.old_count, tokens.size(), splice.shift);
+        tokens = std::move(result);
+    }
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_RETOKENIZE_HPP_INCLUDED
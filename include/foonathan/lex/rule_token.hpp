@@ -5,6 +5,9 @@
 #ifndef FOONATHAN_LEX_RULE_TOKEN_HPP_INCLUDED
 #define FOONATHAN_LEX_RULE_TOKEN_HPP_INCLUDED
 
+#include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/detail/reached_end.hpp>
+#include <foonathan/lex/detail/simd.hpp>
 #include <foonathan/lex/match_result.hpp>
 #include <foonathan/lex/token_spec.hpp>
 
@@ -65,6 +68,11 @@ namespace lex
         {
             return false;
         }
+
+        static constexpr bool can_start(char) noexcept
+        {
+            return true;
+        }
     };
 
     template <class Token>
@@ -79,6 +87,77 @@ namespace lex
         //=== atomic rules ===//
         namespace detail
         {
+            // whether a match of the rule can start with the given character
+            // conservatively returns true if the rule doesn't know
+            template <class Rule>
+            constexpr auto can_start(int, const Rule& r, char c) noexcept
+                -> decltype(r.can_start(c))
+            {
+                return r.can_start(c);
+            }
+            template <class Rule>
+            constexpr bool can_start(short, const Rule&, char) noexcept
+            {
+                return true;
+            }
+            template <class Rule>
+            constexpr bool can_start(const Rule& r, char c) noexcept
+            {
+                return can_start(0, r, c);
+            }
+
+            // whether the rule can match without consuming characters
+            // conservatively returns true if the rule doesn't know
+            template <class Rule>
+            constexpr auto is_nullable(int, const Rule& r) noexcept -> decltype(r.is_nullable())
+            {
+                return r.is_nullable();
+            }
+            template <class Rule>
+            constexpr bool is_nullable(short, const Rule&) noexcept
+            {
+                return true;
+            }
+            template <class Rule>
+            constexpr bool is_nullable(const Rule& r) noexcept
+            {
+                return is_nullable(0, r);
+            }
+
+            // the end of an input that is followed by a null character
+            struct sentinel_end
+            {
+                const char* ptr;
+
+                constexpr operator const char*() const noexcept
+                {
+                    return ptr;
+                }
+            };
+
+            // whether the current character is `c`
+            constexpr bool peek_char(const char* cur, const char* end, char c) noexcept
+            {
+                return !lex::detail::at_end(cur, end) && *cur == c;
+            }
+            constexpr bool peek_char(const char* cur, sentinel_end end, char c) noexcept
+            {
+                // the null character at the end doesn't need to be checked for other characters
+                return *cur == c && (c != '\0' || cur != end.ptr);
+            }
+
+            // whether the current character matches the predicate
+            template <typename Predicate>
+            constexpr bool peek_predicate(const char* cur, const char* end, Predicate p) noexcept
+            {
+                return !lex::detail::at_end(cur, end) && p(*cur);
+            }
+            template <typename Predicate>
+            constexpr bool peek_predicate(const char* cur, sentinel_end end, Predicate p) noexcept
+            {
+                return p(*cur) && (*cur != '\0' || cur != end.ptr);
+            }
+
             template <class Rule>
             constexpr auto make_rule(Rule r) noexcept
                 -> std::decay_t<decltype(r.try_match(std::declval<const char*&>(), nullptr), r)>
@@ -92,9 +171,10 @@ namespace lex
 
                 constexpr char_(char c) noexcept : c(c) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
-                    if (cur != end && *cur == c)
+                    if (peek_char(cur, end, c))
                     {
                         ++cur;
                         return true;
@@ -102,6 +182,16 @@ namespace lex
                     else
                         return false;
                 }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return first == c;
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return false;
+                }
             };
 
             constexpr char_ make_rule(char c) noexcept
@@ -118,7 +208,8 @@ namespace lex
                 : str(str), length(length)
                 {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
                     if (starts_with(cur, end))
                     {
@@ -129,12 +220,25 @@ namespace lex
                         return false;
                 }
 
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return length > 0u && *str == first;
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return length == 0u;
+                }
+
             private:
                 constexpr bool starts_with(const char* cur, const char* end) const noexcept
                 {
                     auto remaining = static_cast<std::size_t>(end - cur);
                     if (remaining < length)
+                    {
+                        lex::detail::report_reached_end();
                         return false;
+                    }
 
                     auto str_cur = str;
                     auto str_end = str + length;
@@ -146,6 +250,22 @@ namespace lex
                         ++str_cur;
                     }
 
+                    return true;
+                }
+                constexpr bool starts_with(const char* cur, sentinel_end end) const noexcept
+                {
+                    // a mismatch happens at the null character at the end,
+                    // unless the string contains a null character itself
+                    auto str_cur = str;
+                    auto str_end = str + length;
+                    while (str_cur != str_end)
+                    {
+                        if (*cur != *str_cur || (*str_cur == '\0' && cur == end.ptr))
+                            return false;
+                        ++cur;
+                        ++str_cur;
+                    }
+
                     return true;
                 }
             };
@@ -166,9 +286,10 @@ namespace lex
 
                 constexpr ascii_predicate(Predicate p) noexcept : p(p) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
-                    if (cur != end && p(*cur))
+                    if (peek_predicate(cur, end, p))
                     {
                         ++cur;
                         return true;
@@ -176,6 +297,16 @@ namespace lex
                     else
                         return false;
                 }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return p(first);
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return false;
+                }
             };
 
             template <typename Predicate, typename = decltype(!std::declval<Predicate>()('\0'))>
@@ -184,6 +315,26 @@ namespace lex
                 return {p};
             }
 
+            // the character class of one of the `lex::ascii` predicates that can be skipped quickly
+            template <typename Predicate>
+            constexpr lex::detail::simd_char_class simd_class_of(std::false_type,
+                                                                 Predicate) noexcept
+            {
+                return lex::detail::simd_char_class::none;
+            }
+            template <typename Predicate>
+            constexpr lex::detail::simd_char_class simd_class_of(std::true_type,
+                                                                 Predicate p) noexcept
+            {
+                using fn_ptr = bool (*)(char);
+                if (static_cast<fn_ptr>(p) == static_cast<fn_ptr>(&ascii::is_space))
+                    return lex::detail::simd_char_class::space;
+                else if (static_cast<fn_ptr>(p) == static_cast<fn_ptr>(&ascii::is_blank))
+                    return lex::detail::simd_char_class::blank;
+                else
+                    return lex::detail::simd_char_class::none;
+            }
+
             template <typename Function>
             struct function : base_rule
             {
@@ -191,12 +342,25 @@ namespace lex
 
                 constexpr function(Function f) noexcept : func(f) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
                     auto result = func(cur, end);
                     cur += result;
                     return result > 0u;
                 }
+
+                constexpr bool can_start(char) const noexcept
+                {
+                    // we can't know
+                    return true;
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    // a successful match consumes at least one character
+                    return false;
+                }
             };
 
             template <typename Function, typename = decltype(!std::declval<Function>()(
@@ -221,17 +385,31 @@ namespace lex
             template <std::size_t N>
             struct any : base_rule
             {
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
                     auto remaining = end - cur;
                     if (static_cast<std::size_t>(remaining) < N)
+                    {
+                        lex::detail::report_reached_end();
                         return false;
+                    }
                     else
                     {
                         cur += N;
                         return true;
                     }
                 }
+
+                constexpr bool can_start(char) const noexcept
+                {
+                    return N > 0u;
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return N == 0u;
+                }
             };
         } // namespace detail
 
@@ -244,9 +422,20 @@ namespace lex
         {
             struct eof : base_rule
             {
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
+                {
+                    return lex::detail::at_end(cur, end);
+                }
+
+                constexpr bool can_start(char) const noexcept
+                {
+                    return false;
+                }
+
+                constexpr bool is_nullable() const noexcept
                 {
-                    return cur == end;
+                    return true;
                 }
             };
         } // namespace detail
@@ -257,7 +446,18 @@ namespace lex
         {
             struct fail : base_rule
             {
-                constexpr bool try_match(const char*&, const char*) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*&, End) const noexcept
+                {
+                    return false;
+                }
+
+                constexpr bool can_start(char) const noexcept
+                {
+                    return false;
+                }
+
+                constexpr bool is_nullable() const noexcept
                 {
                     return false;
                 }
@@ -277,7 +477,8 @@ namespace lex
 
                 constexpr sequence(R1 r1, R2 r2) noexcept : r1(r1), r2(r2) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
                     auto copy = cur;
 
@@ -289,6 +490,17 @@ namespace lex
                     cur = copy;
                     return true;
                 }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return detail::can_start(r1, first)
+                           || (detail::is_nullable(r1) && detail::can_start(r2, first));
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return detail::is_nullable(r1) && detail::is_nullable(r2);
+                }
             };
         } // namespace detail
 
@@ -311,7 +523,8 @@ namespace lex
 
                 constexpr choice(R1 r1, R2 r2) noexcept : r1(r1), r2(r2) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
                     if (r1.try_match(cur, end))
                         return true;
@@ -320,6 +533,16 @@ namespace lex
                     else
                         return false;
                 }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return detail::can_start(r1, first) || detail::can_start(r2, first);
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return detail::is_nullable(r1) || detail::is_nullable(r2);
+                }
             };
         } // namespace detail
 
@@ -341,11 +564,22 @@ namespace lex
 
                 constexpr optional(R r) noexcept : r(r) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
                     r.try_match(cur, end);
                     return true;
                 }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return detail::can_start(r, first);
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return true;
+                }
             };
         } // namespace detail
 
@@ -357,6 +591,29 @@ namespace lex
 
         namespace detail
         {
+            // matches the rule as often as possible
+            template <class R, class End>
+            constexpr void match_star(const R& r, const char*& cur, End end) noexcept
+            {
+                while (r.try_match(cur, end))
+                {
+                }
+            }
+            template <typename Predicate, class End>
+            constexpr void match_star(const ascii_predicate<Predicate>& r, const char*& cur,
+                                      End end) noexcept
+            {
+                auto cls = simd_class_of(std::is_convertible<Predicate, bool (*)(char)>{}, r.p);
+                if (cls != lex::detail::simd_char_class::none
+                    && !lex::detail::is_constant_evaluated())
+                    // skip blocks of characters at once, the loop matches the remaining ones
+                    cur = lex::detail::simd_skip_class(cls, cur, end);
+
+                while (r.try_match(cur, end))
+                {
+                }
+            }
+
             template <class R>
             struct zero_or_more : base_rule
             {
@@ -364,11 +621,20 @@ namespace lex
 
                 constexpr zero_or_more(R r) noexcept : r(r) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
+                {
+                    match_star(r, cur, end);
+                    return true;
+                }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return detail::can_start(r, first);
+                }
+
+                constexpr bool is_nullable() const noexcept
                 {
-                    while (r.try_match(cur, end))
-                    {
-                    }
                     return true;
                 }
             };
@@ -395,11 +661,23 @@ namespace lex
 
                 constexpr lookahead(R r) noexcept : r(r) {}
 
-                constexpr bool try_match(const char* const& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char* const& cur, End end) const noexcept
                 {
                     auto dummy = cur;
                     return r.try_match(dummy, end);
                 }
+
+                constexpr bool can_start(char) const noexcept
+                {
+                    // doesn't consume anything
+                    return false;
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return true;
+                }
             };
         } // namespace detail
 
@@ -424,11 +702,23 @@ namespace lex
 
                 constexpr neg_lookahead(R r) noexcept : r(r) {}
 
-                constexpr bool try_match(const char* const& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char* const& cur, End end) const noexcept
                 {
                     auto dummy = cur;
                     return !r.try_match(dummy, end);
                 }
+
+                constexpr bool can_start(char) const noexcept
+                {
+                    // doesn't consume anything
+                    return false;
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return true;
+                }
             };
         } // namespace detail
 
@@ -453,11 +743,23 @@ namespace lex
 
                 constexpr lookback(R r) noexcept : r(r) {}
 
-                constexpr bool try_match(const char* const& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char* const& cur, End end) const noexcept
                 {
                     auto dummy = cur - N;
                     return r.try_match(dummy, end);
                 }
+
+                constexpr bool can_start(char) const noexcept
+                {
+                    // doesn't consume anything
+                    return false;
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return true;
+                }
             };
         } // namespace detail
 
@@ -472,7 +774,8 @@ namespace lex
 
                 constexpr rule_minus(Rule rule, Subtrahend sub) noexcept : rule(rule), sub(sub) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
                     auto copy = cur;
                     if (!rule.try_match(copy, end))
@@ -487,6 +790,16 @@ namespace lex
                     cur = copy;
                     return true;
                 }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return detail::can_start(rule, first);
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return detail::is_nullable(rule);
+                }
             };
         } // namespace detail
 
@@ -549,7 +862,8 @@ namespace lex
 
                 constexpr repeated(Rule rule) noexcept : rule(rule) {}
 
-                constexpr bool try_match(const char*& cur, const char* end) const noexcept
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
                 {
                     auto copy = cur;
 
@@ -570,6 +884,16 @@ namespace lex
                     // now rule must not match any more
                     return !rule.try_match(copy, end);
                 }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    return detail::can_start(rule, first);
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return Min == 0u || detail::is_nullable(rule);
+                }
             };
         } // namespace detail
 
@@ -600,12 +924,20 @@ namespace lex
         }
     } // namespace token_rule
 
+    namespace detail
+    {
+        // the end passed to the rules
+        template <class TokenSpec>
+        using rule_end = std::conditional_t<null_terminated<TokenSpec>::value,
+                                            token_rule::detail::sentinel_end, const char*>;
+    } // namespace detail
+
     template <class TokenSpec>
     class rule_matcher
     {
     public:
         explicit constexpr rule_matcher(const char* str, const char* end) noexcept
-        : begin_(str), cur_(str), end_(end)
+        : begin_(str), cur_(str), end_{end}
         {}
 
         template <class Rule>
@@ -646,9 +978,9 @@ namespace lex
             return static_cast<std::size_t>(cur_ - begin_);
         }
 
-        const char* begin_;
-        const char* cur_;
-        const char* end_;
+        const char*                 begin_;
+        const char*                 cur_;
+        detail::rule_end<TokenSpec> end_;
     };
 
     template <class Derived, class TokenSpec>
@@ -660,6 +992,11 @@ namespace lex
             constexpr auto rule = Derived::rule();
             return lex::rule_matcher<TokenSpec>(str, end).finish(Derived{}, rule);
         }
+
+        static constexpr bool can_start(char c) noexcept
+        {
+            return token_rule::detail::can_start(token_rule::r(Derived::rule()), c);
+        }
     };
 } // namespace lex
 } // namespace foonathan
@@ -0,0 +1,208 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_SEGMENTED_TOKENIZER_HPP_INCLUDED
+#define FOONATHAN_LEX_SEGMENTED_TOKENIZER_HPP_INCLUDED
+
+#include <vector>
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    template <class TokenSpec>
+    class segmented_tokenizer
+    {
+        using matcher = detail::token_spec_matcher<TokenSpec>;
+        static_assert(!detail::null_terminated<TokenSpec>::value,
+                      "segmented input can't be null terminated");
+
+    public:
+        static constexpr std::size_t default_lookahead = 64u;
+
+        //=== constructors ===//
+        // the input is the concatenation of the segments
+        explicit segmented_tokenizer(const token_spelling* segments, std::size_t count,
+                                     std::size_t lookahead = default_lookahead)
+        : segments_(segments), count_(count), lookahead_(lookahead),
+          last_result_(match_result<TokenSpec>::unmatched())
+        {
+            if (count_ > 0u)
+            {
+                ptr_ = segments_[0].data();
+                end_ = segments_[0].data() + segments_[0].size();
+            }
+            match();
+            skip_whitespace();
+        }
+
+        //=== tokenizer functions ===//
+        // a token that crosses a segment boundary points into an internal buffer,
+        // its spelling is only valid until the next call to `get()` or `bump()`
+        token<TokenSpec> peek() const noexcept
+        {
+            return detail::token_factory::make(last_result_.kind, token_ptr_, last_result_.bump);
+        }
+
+        bool is_done() const noexcept
+        {
+            FOONATHAN_LEX_ASSERT(last_result_.bump != 0 || peek().is(eof_token{}));
+            return last_result_.bump == 0;
+        }
+
+        token<TokenSpec> get()
+        {
+            auto result = peek();
+            bump();
+            return result;
+        }
+
+        void bump()
+        {
+            // stitch into the other buffer, where the current token isn't
+            current_stitch_ ^= 1u;
+            advance();
+            skip_whitespace();
+        }
+
+        //=== getters ===//
+        // the offset of the current token from the beginning of the input
+        std::size_t current_offset() const noexcept
+        {
+            return offset_;
+        }
+
+        // the index of the segment the current token begins in
+        std::size_t current_segment() const noexcept
+        {
+            return segment_;
+        }
+
+    private:
+        bool is_last_segment() const noexcept
+        {
+            return segment_ + 1u >= count_;
+        }
+
+        void next_segment() noexcept
+        {
+            ++segment_;
+            ptr_ = segments_[segment_].data();
+            end_ = ptr_ + segments_[segment_].size();
+        }
+
+        // moves to the end of the current token
+        void advance()
+        {
+            offset_ += last_result_.bump;
+
+            auto bump = last_result_.bump;
+            while (bump > static_cast<std::size_t>(end_ - ptr_))
+            {
+                bump -= static_cast<std::size_t>(end_ - ptr_);
+                next_segment();
+            }
+            ptr_ += bump;
+
+            match();
+        }
+
+        void skip_whitespace()
+        {
+            while (last_result_.kind.template is_category<is_whitespace_token>())
+                advance();
+        }
+
+        void match()
+        {
+            while (ptr_ == end_ && !is_last_segment())
+                next_segment();
+
+            // match directly in the segment,
+            // unless characters of the next segment might change the token
+            auto& reached_end = detail::reached_end_flag();
+            reached_end       = false;
+            last_result_      = matcher::try_match(ptr_, end_);
+            token_ptr_        = ptr_;
+            if (!is_last_segment() && need_input(reached_end, ptr_, end_))
+                match_stitched();
+        }
+
+        // whether the characters after `end` might change the match of the token at `ptr`
+        bool need_input(bool reached_end, const char* ptr, const char* end) const noexcept
+        {
+            // a custom `try_match()` can't report that it has looked at the end,
+            // so it must not look further than the lookahead past the end of its token
+            return reached_end
+                   || static_cast<std::size_t>(end - (ptr + last_result_.bump)) <= lookahead_;
+        }
+
+        // matches the token in a copy of the rest of the segment and the following characters
+        void match_stitched()
+        {
+            auto& stitch = stitch_[current_stitch_];
+            stitch.assign(ptr_, end_);
+
+            auto next      = segment_ + 1u;
+            auto next_ptr  = segments_[next].data();
+            auto exhausted = false;
+            for (auto size = stitch.size() + lookahead_ + 1u;; size *= 2u)
+            {
+                while (stitch.size() < size && !exhausted)
+                {
+                    auto available = static_cast<std::size_t>(
+                        segments_[next].data() + segments_[next].size() - next_ptr);
+                    auto count = std::min(available, size - stitch.size());
+                    stitch.insert(stitch.end(), next_ptr, next_ptr + count);
+                    next_ptr += count;
+
+                    if (count == available)
+                    {
+                        if (++next == count_)
+                            exhausted = true;
+                        else
+                            next_ptr = segments_[next].data();
+                    }
+                }
+
+                auto  stitch_end  = stitch.data() + stitch.size();
+                auto& reached_end = detail::reached_end_flag();
+                reached_end       = false;
+                last_result_      = matcher::try_match(stitch.data(), stitch_end);
+                if (exhausted || !need_input(reached_end, stitch.data(), stitch_end))
+                    break;
+            }
+
+            // only a token that crosses the boundary needs to point into the stitch buffer
+            if (last_result_.bump > static_cast<std::size_t>(end_ - ptr_))
+                token_ptr_ = stitch.data();
+        }
+
+        const token_spelling* segments_;
+        std::size_t           count_;
+        std::size_t           lookahead_;
+
+        // the current token begins at `ptr_` in the segment `segment_`, which ends at `end_`,
+        // `token_ptr_` is where its spelling is stored
+        std::size_t segment_   = 0;
+        const char* ptr_       = nullptr;
+        const char* end_       = nullptr;
+        const char* token_ptr_ = nullptr;
+        std::size_t offset_    = 0;
+
+        match_result<TokenSpec> last_result_;
+
+        // two buffers, so the spelling of the previous token stays valid
+        std::vector<char> stitch_[2];
+        unsigned          current_stitch_ = 0;
+    };
+
+    template <class TokenSpec>
+    constexpr std::size_t segmented_tokenizer<TokenSpec>::default_lookahead;
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_SEGMENTED_TOKENIZER_HPP_INCLUDED
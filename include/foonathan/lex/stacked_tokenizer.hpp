@@ -0,0 +1,215 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_STACKED_TOKENIZER_HPP_INCLUDED
+#define FOONATHAN_LEX_STACKED_TOKENIZER_HPP_INCLUDED
+
+#include <vector>
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    template <class TokenSpec>
+    class stacked_tokenizer;
+
+    // a token that also knows the buffer it is from
+    template <class TokenSpec>
+    class stacked_token : public token<TokenSpec>
+    {
+    public:
+        constexpr stacked_token() noexcept : token<TokenSpec>(), buffer_(0) {}
+
+        explicit constexpr stacked_token(const token<TokenSpec>& token, std::size_t buffer) noexcept
+        : lex::token<TokenSpec>(token), buffer_(buffer)
+        {}
+
+        // the id of the buffer, as returned by `stacked_tokenizer::push()`
+        constexpr std::size_t buffer() const noexcept
+        {
+            return buffer_;
+        }
+
+        using token<TokenSpec>::offset;
+
+        // the offset from the beginning of the token's buffer
+        std::size_t offset(const stacked_tokenizer<TokenSpec>& tokenizer) const noexcept
+        {
+            return static_cast<std::size_t>(this->spelling().data()
+                                            - tokenizer.buffer_begin(buffer_));
+        }
+
+    private:
+        std::size_t buffer_;
+    };
+
+    template <class TokenSpec>
+    class stacked_tokenizer
+    {
+        using matcher          = detail::token_spec_matcher<TokenSpec>;
+        using trivia_begin_ptr = detail::trivia_begin<detail::preserve_trivia<TokenSpec>::value>;
+        static_assert(detail::mp::mp_all_of<typename TokenSpec::list, is_token>::value,
+                      "invalid types in token specifications");
+
+    public:
+        //=== constructors ===//
+        explicit stacked_tokenizer(const char* ptr, std::size_t size)
+        : stacked_tokenizer(ptr, ptr + size)
+        {}
+
+        explicit stacked_tokenizer(const char* begin, const char* end)
+        : trivia_begin_(begin), last_result_(match_result<TokenSpec>::unmatched())
+        {
+            FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                       "input must be null terminated");
+            begins_.push_back(begin);
+            end_ = end;
+            match(begin);
+        }
+
+        template <std::size_t N>
+        explicit stacked_tokenizer(const char (&array)[N]) : stacked_tokenizer(array, array + N - 1)
+        {}
+
+        //=== tokenizer functions ===//
+        stacked_token<TokenSpec> peek() const noexcept
+        {
+            return stacked_token<TokenSpec>(detail::token_factory::make(last_result_.kind, ptr_,
+                                                                        last_result_.bump,
+                                                                        trivia_begin_.size(ptr_)),
+                                            buffer_);
+        }
+
+        // only true at the end of the initial buffer, the others are popped at their end
+        bool is_done() const noexcept
+        {
+            FOONATHAN_LEX_ASSERT(last_result_.bump != 0 || peek().is(eof_token{}));
+            return last_result_.bump == 0;
+        }
+
+        stacked_token<TokenSpec> get() noexcept
+        {
+            auto result = peek();
+            bump();
+            return result;
+        }
+
+        void bump() noexcept
+        {
+            match(ptr_ + last_result_.bump);
+        }
+
+        //=== buffers ===//
+        // tokenizes [begin, end) before continuing with the current token, returns its id
+        std::size_t push(const char* begin, const char* end)
+        {
+            FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                       "input must be null terminated");
+            stack_.push_back(frame{ptr_, trivia_begin_, end_, last_result_, buffer_});
+
+            auto id = begins_.size();
+            begins_.push_back(begin);
+            buffer_ = id;
+            end_    = end;
+            match(begin);
+            return id;
+        }
+
+        std::size_t push(const char* ptr, std::size_t size)
+        {
+            return push(ptr, ptr + size);
+        }
+
+        // the number of buffers that have been pushed and not reached their end yet
+        std::size_t depth() const noexcept
+        {
+            return stack_.size();
+        }
+
+        // the id of the buffer of the current token
+        std::size_t buffer() const noexcept
+        {
+            return buffer_;
+        }
+
+        // the beginning of the buffer with the given id
+        const char* buffer_begin(std::size_t id) const noexcept
+        {
+            FOONATHAN_LEX_PRECONDITION(id < begins_.size(), "invalid buffer id");
+            return begins_[id];
+        }
+
+        //=== getters ===//
+        const char* begin_ptr() const noexcept
+        {
+            return begins_[buffer_];
+        }
+
+        const char* current_ptr() const noexcept
+        {
+            FOONATHAN_LEX_ASSERT(peek().spelling().data() == ptr_);
+            return ptr_;
+        }
+
+        const char* end_ptr() const noexcept
+        {
+            return end_;
+        }
+
+    private:
+        // matches the next non-whitespace token,
+        // continuing with the outer buffer at the end of a pushed one
+        void match(const char* position) noexcept
+        {
+            trivia_begin_.set(position);
+            ptr_         = position;
+            last_result_ = matcher::try_match(ptr_, end_);
+            while (true)
+            {
+                if (last_result_.kind.template is_category<is_whitespace_token>())
+                {
+                    ptr_ += last_result_.bump;
+                    last_result_ = matcher::try_match(ptr_, end_);
+                }
+                else if (last_result_.bump == 0u && !stack_.empty())
+                {
+                    auto& outer   = stack_.back();
+                    ptr_          = outer.ptr;
+                    trivia_begin_ = outer.trivia_begin;
+                    end_          = outer.end;
+                    last_result_  = outer.result;
+                    buffer_       = outer.buffer;
+                    stack_.pop_back();
+                }
+                else
+                    break;
+            }
+        }
+
+        // the state of a buffer while a nested one is tokenized
+        struct frame
+        {
+            const char*             ptr;
+            trivia_begin_ptr        trivia_begin;
+            const char*             end;
+            match_result<TokenSpec> result;
+            std::size_t             buffer;
+        };
+
+        const char*      ptr_{};
+        const char*      end_{};
+        trivia_begin_ptr trivia_begin_;
+
+        match_result<TokenSpec> last_result_;
+        std::size_t             buffer_{};
+
+        std::vector<frame>       stack_;
+        std::vector<const char*> begins_;
+    };
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_STACKED_TOKENIZER_HPP_INCLUDED
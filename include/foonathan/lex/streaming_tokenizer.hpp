@@ -0,0 +1,197 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_STREAMING_TOKENIZER_HPP_INCLUDED
+#define FOONATHAN_LEX_STREAMING_TOKENIZER_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    template <class TokenSpec>
+    class streaming_tokenizer
+    {
+        using matcher = detail::token_spec_matcher<TokenSpec>;
+        static_assert(!detail::null_terminated<TokenSpec>::value,
+                      "streaming input can't be null terminated");
+
+    public:
+        // writes up to `size` characters into `buffer` and returns the number of characters,
+        // zero means the end of the input
+        using refill_fn = std::function<std::size_t(char* buffer, std::size_t size)>;
+
+        static constexpr std::size_t default_chunk_size = 64 * 1024u;
+        static constexpr std::size_t default_lookahead  = 64u;
+
+        //=== constructors ===//
+        explicit streaming_tokenizer(refill_fn   refill,
+                                     std::size_t chunk_size = default_chunk_size,
+                                     std::size_t lookahead  = default_lookahead)
+        : refill_(std::move(refill)), chunk_size_(chunk_size), lookahead_(lookahead),
+          last_result_(match_result<TokenSpec>::unmatched())
+        {
+            FOONATHAN_LEX_PRECONDITION(chunk_size > 0u, "chunk size must not be zero");
+            // unmatched has a bump of zero, so it just matches the first token
+            advance();
+        }
+
+        //=== tokenizer functions ===//
+        // the spelling of the token stays valid until the next call to a non-const member function
+        token<TokenSpec> peek()
+        {
+            sync();
+            return current();
+        }
+
+        bool is_done()
+        {
+            sync();
+            FOONATHAN_LEX_ASSERT(last_result_.bump != 0 || current().is(eof_token{}));
+            return last_result_.bump == 0;
+        }
+
+        token<TokenSpec> get()
+        {
+            sync();
+            // only advance on the next call, so the input isn't refilled while the token is used
+            pending_bump_ = true;
+            return current();
+        }
+
+        void bump()
+        {
+            sync();
+            advance();
+        }
+
+        //=== getters ===//
+        std::uint64_t offset(const token<TokenSpec>& token) const noexcept
+        {
+            return buffer_offset_
+                   + static_cast<std::uint64_t>(token.spelling().data() - buffer_.get());
+        }
+
+        std::uint64_t current_offset()
+        {
+            sync();
+            return buffer_offset_ + static_cast<std::uint64_t>(ptr_ - buffer_.get());
+        }
+
+        std::size_t buffer_capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+    private:
+        token<TokenSpec> current() const noexcept
+        {
+            return detail::token_factory::make(last_result_.kind, ptr_, last_result_.bump);
+        }
+
+        void sync()
+        {
+            if (pending_bump_)
+            {
+                pending_bump_ = false;
+                advance();
+            }
+        }
+
+        // moves the characters that are still needed to the front and reads a new chunk,
+        // returns false if there was nothing left to read
+        bool refill()
+        {
+            buffer_offset_ += static_cast<std::uint64_t>(ptr_ - buffer_.get());
+
+            auto size = static_cast<std::size_t>(end_ - ptr_);
+            if (capacity_ - size < chunk_size_)
+            {
+                // the current token is longer than a chunk, need a bigger buffer
+                std::unique_ptr<char[]> buffer(new char[size + chunk_size_]);
+                if (size > 0u)
+                    std::memcpy(buffer.get(), ptr_, size);
+                buffer_.swap(buffer);
+                capacity_ = size + chunk_size_;
+            }
+            else if (size > 0u)
+                std::memmove(buffer_.get(), ptr_, size);
+
+            ptr_ = buffer_.get();
+            end_ = ptr_ + size;
+
+            auto read = refill_(buffer_.get() + size, chunk_size_);
+            FOONATHAN_LEX_ASSERT(read <= chunk_size_);
+            end_ += read;
+            return read > 0u;
+        }
+
+        // matches the token at the current position,
+        // reading more input until it can't be affected by characters that weren't read yet
+        void match_next()
+        {
+            while (true)
+            {
+                auto& reached_end = detail::reached_end_flag();
+                reached_end       = false;
+                last_result_      = matcher::try_match(ptr_, end_);
+                if (exhausted_ || !need_input(reached_end))
+                    break;
+
+                if (!refill())
+                    exhausted_ = true;
+            }
+        }
+
+        // whether the current match might change with the characters after `end_`
+        bool need_input(bool reached_end) const noexcept
+        {
+            if (reached_end || last_result_.bump == 0)
+                return true;
+
+            // a custom `try_match()` can't report that it has looked at the end,
+            // so it must not look further than the lookahead past the end of its token
+            auto token_end = ptr_ + last_result_.bump;
+            return static_cast<std::size_t>(end_ - token_end) < lookahead_;
+        }
+
+        void advance()
+        {
+            ptr_ += last_result_.bump;
+            match_next();
+            while (last_result_.kind.template is_category<is_whitespace_token>())
+            {
+                ptr_ += last_result_.bump;
+                match_next();
+            }
+        }
+
+        refill_fn               refill_;
+        std::unique_ptr<char[]> buffer_;
+        std::size_t             capacity_      = 0;
+        std::size_t             chunk_size_    = 0;
+        std::size_t             lookahead_     = 0;
+        std::uint64_t           buffer_offset_ = 0;
+        const char*             ptr_           = nullptr;
+        const char*             end_           = nullptr;
+        bool                    exhausted_     = false;
+        bool                    pending_bump_  = false;
+
+        match_result<TokenSpec> last_result_;
+    };
+
+    template <class TokenSpec>
+    constexpr std::size_t streaming_tokenizer<TokenSpec>::default_chunk_size;
+    template <class TokenSpec>
+    constexpr std::size_t streaming_tokenizer<TokenSpec>::default_lookahead;
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_STREAMING_TOKENIZER_HPP_INCLUDED
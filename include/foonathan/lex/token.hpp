@@ -15,11 +15,82 @@ namespace lex
     template <class TokenSpec>
     class tokenizer;
 
+    namespace detail
+    {
+        struct token_factory;
+
+        // the number of characters of the trivia before a token,
+        // only stored if trivia is preserved
+        template <bool Preserve>
+        class trivia_size
+        {
+        public:
+            explicit constexpr trivia_size(std::size_t) noexcept {}
+
+            constexpr std::size_t get() const noexcept
+            {
+                return 0;
+            }
+        };
+
+        template <>
+        class trivia_size<true>
+        {
+        public:
+            explicit constexpr trivia_size(std::size_t size) noexcept : size_(size) {}
+
+            constexpr std::size_t get() const noexcept
+            {
+                return size_;
+            }
+
+        private:
+            std::size_t size_;
+        };
+
+        // where the trivia before the current token of a tokenizer begins,
+        // only stored if trivia is preserved
+        template <bool Preserve>
+        class trivia_begin
+        {
+        public:
+            explicit constexpr trivia_begin(const char*) noexcept {}
+
+            constexpr void set(const char*) noexcept {}
+
+            constexpr std::size_t size(const char*) const noexcept
+            {
+                return 0;
+            }
+        };
+
+        template <>
+        class trivia_begin<true>
+        {
+        public:
+            explicit constexpr trivia_begin(const char* ptr) noexcept : ptr_(ptr) {}
+
+            constexpr void set(const char* ptr) noexcept
+            {
+                ptr_ = ptr;
+            }
+
+            // the number of characters of the trivia before a token that begins at `token_ptr`
+            constexpr std::size_t size(const char* token_ptr) const noexcept
+            {
+                return static_cast<std::size_t>(token_ptr - ptr_);
+            }
+
+        private:
+            const char* ptr_;
+        };
+    } // namespace detail
+
     template <class TokenSpec>
     class token
     {
     public:
-        constexpr token() noexcept : ptr_(nullptr), size_(0), kind_() {}
+        constexpr token() noexcept : ptr_(nullptr), size_(0), kind_(), trivia_(0) {}
 
         constexpr token_kind<TokenSpec> kind() const noexcept
         {
@@ -53,24 +124,48 @@ namespace lex
             return token_spelling(ptr_, size_);
         }
 
+        // the whitespace tokens directly before the token,
+        // always empty unless the token spec preserves trivia
+        constexpr token_spelling leading_trivia() const noexcept
+        {
+            return token_spelling(ptr_ - trivia_.get(), trivia_.get());
+        }
+
         constexpr std::size_t offset(const tokenizer<TokenSpec>& tokenizer) const noexcept
         {
             return static_cast<std::size_t>(ptr_ - tokenizer.begin_ptr());
         }
 
     private:
-        explicit constexpr token(token_kind<TokenSpec> kind, const char* ptr,
-                                 std::size_t size) noexcept
-        : ptr_(ptr), size_(size), kind_(kind)
+        explicit constexpr token(token_kind<TokenSpec> kind, const char* ptr, std::size_t size,
+                                 std::size_t trivia_size = 0) noexcept
+        : ptr_(ptr), size_(size), kind_(kind), trivia_(trivia_size)
         {}
 
         const char*           ptr_;
         std::size_t           size_;
         token_kind<TokenSpec> kind_;
 
-        friend tokenizer<TokenSpec>;
+        detail::trivia_size<detail::preserve_trivia<TokenSpec>::value> trivia_;
+
+        friend detail::token_factory;
     };
 
+    namespace detail
+    {
+        // creates tokens on behalf of the tokenizers
+        struct token_factory
+        {
+            template <class TokenSpec>
+            static constexpr token<TokenSpec> make(token_kind<TokenSpec> kind, const char* ptr,
+                                                   std::size_t size,
+                                                   std::size_t trivia_size = 0) noexcept
+            {
+                return token<TokenSpec>(kind, ptr, size, trivia_size);
+            }
+        };
+    } // namespace detail
+
     template <class Token, class Payload = void>
     class static_token;
 
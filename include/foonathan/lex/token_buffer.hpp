@@ -0,0 +1,268 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_TOKEN_BUFFER_HPP_INCLUDED
+#define FOONATHAN_LEX_TOKEN_BUFFER_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    struct text_edit;
+    struct token_splice;
+
+    template <class TokenSpec>
+    class token_buffer;
+
+    namespace detail
+    {
+        template <class TokenSpec>
+        const char* tokenize_chunk(const char* begin, const char* start, const char* stop,
+                                   const char* end, token_buffer<TokenSpec>& result);
+        template <class TokenSpec>
+        void stitch_chunks(const char* begin, const char* end, token_buffer<TokenSpec>& buffer,
+                           const std::vector<const char*>& starts,
+                           const std::vector<const char*>& stops,
+                           const token_buffer<TokenSpec>*  chunks);
+    } // namespace detail
+
+    template <class TokenSpec>
+    class token_buffer
+    {
+    public:
+        using kind_id = token_kind_detail::id_type<TokenSpec>;
+
+        token_buffer() noexcept = default;
+
+        //=== access ===//
+        bool empty() const noexcept
+        {
+            return size_ == 0u;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        token<TokenSpec> operator[](std::size_t i) const noexcept
+        {
+            return detail::token_factory::make(kind(i), begin_ + offsets_[i], lengths_[i],
+                                               trivia_size(detail::preserve_trivia<TokenSpec>{},
+                                                           i));
+        }
+
+        token_kind<TokenSpec> kind(std::size_t i) const noexcept
+        {
+            FOONATHAN_LEX_PRECONDITION(i < size(), "index out of range");
+            return token_kind<TokenSpec>::from_id(kinds_[i]);
+        }
+
+        std::uint32_t offset(std::size_t i) const noexcept
+        {
+            FOONATHAN_LEX_PRECONDITION(i < size(), "index out of range");
+            return offsets_[i];
+        }
+
+        std::uint32_t length(std::size_t i) const noexcept
+        {
+            FOONATHAN_LEX_PRECONDITION(i < size(), "index out of range");
+            return lengths_[i];
+        }
+
+        //=== arrays ===//
+        const kind_id* kind_ids() const noexcept
+        {
+            return kinds_.get();
+        }
+
+        const std::uint32_t* offsets() const noexcept
+        {
+            return offsets_.get();
+        }
+
+        const std::uint32_t* lengths() const noexcept
+        {
+            return lengths_.get();
+        }
+
+        const char* begin_ptr() const noexcept
+        {
+            return begin_;
+        }
+
+        //=== modifiers ===//
+        void reserve(std::size_t capacity)
+        {
+            if (capacity > capacity_)
+                reallocate(capacity);
+        }
+
+        void clear() noexcept
+        {
+            size_ = 0;
+        }
+
+    private:
+        // the whitespace before a token is the gap to the previous one,
+        // or to where the tokenization started for the first token
+        std::size_t trivia_size(std::true_type, std::size_t i) const noexcept
+        {
+            auto previous_end = i == 0u ? start_ : offsets_[i - 1u] + lengths_[i - 1u];
+            return offsets_[i] - previous_end;
+        }
+        std::size_t trivia_size(std::false_type, std::size_t) const noexcept
+        {
+            return 0;
+        }
+
+        // clears the buffer before appending tokens whose trivia begins at `trivia_begin`
+        void start(const char* begin, const char* trivia_begin) noexcept
+        {
+            clear();
+            begin_ = begin;
+            start_ = static_cast<std::uint32_t>(trivia_begin - begin);
+        }
+
+        // appends the tokens starting at `cur` up to the first one that starts at or after `stop`,
+        // returns the beginning of that token or where the end of the input was reached
+        const char* append_tokens(const char* cur, const char* stop, const char* end)
+        {
+            using matcher = detail::token_spec_matcher<TokenSpec>;
+
+            // every token consumes at least one character
+            auto max_size = size_ + static_cast<std::size_t>(end - cur);
+
+            // same as repeatedly calling tokenizer::get(),
+            // but keeps the state in local variables and writes the arrays directly
+            auto begin    = begin_;
+            auto size     = size_;
+            auto capacity = capacity_;
+            auto kinds    = kinds_.get();
+            auto offsets  = offsets_.get();
+            auto lengths  = lengths_.get();
+
+            while (cur < stop)
+            {
+                auto result = matcher::try_match(cur, end);
+                if (result.bump == 0)
+                    // eof
+                    break;
+
+                if (!result.kind.template is_category<is_whitespace_token>())
+                {
+                    if (size == capacity)
+                    {
+                        size_ = size;
+                        grow(max_size);
+                        capacity = capacity_;
+                        kinds    = kinds_.get();
+                        offsets  = offsets_.get();
+                        lengths  = lengths_.get();
+                    }
+
+                    kinds[size]   = result.kind.get();
+                    offsets[size] = static_cast<std::uint32_t>(cur - begin);
+                    lengths[size] = static_cast<std::uint32_t>(result.bump);
+                    ++size;
+                }
+                cur += result.bump;
+            }
+
+            size_ = size;
+            return cur;
+        }
+
+        // appends the tokens [first, last) of `other`, adding `shift` to their offsets
+        void append(const token_buffer& other, std::size_t first, std::size_t last,
+                    std::ptrdiff_t shift)
+        {
+            reserve(size_ + (last - first));
+            std::copy(other.kinds_.get() + first, other.kinds_.get() + last, kinds_.get() + size_);
+            std::transform(other.offsets_.get() + first, other.offsets_.get() + last,
+                           offsets_.get() + size_, [&](std::uint32_t offset) {
+                               return static_cast<std::uint32_t>(offset + shift);
+                           });
+            std::copy(other.lengths_.get() + first, other.lengths_.get() + last,
+                      lengths_.get() + size_);
+            size_ += last - first;
+        }
+
+        // grows the arrays, so they have room for at least one more token,
+        // but no more than `max_size` tokens
+        void grow(std::size_t max_size)
+        {
+            auto new_capacity = capacity_ < 64u ? 128u : 2 * capacity_;
+            reallocate(new_capacity < max_size ? new_capacity : max_size);
+        }
+
+        void reallocate(std::size_t capacity)
+        {
+            // arrays are left uninitialized, tokens are only written
+            std::unique_ptr<kind_id[]>       kinds(new kind_id[capacity]);
+            std::unique_ptr<std::uint32_t[]> offsets(new std::uint32_t[capacity]);
+            std::unique_ptr<std::uint32_t[]> lengths(new std::uint32_t[capacity]);
+            std::copy(kinds_.get(), kinds_.get() + size_, kinds.get());
+            std::copy(offsets_.get(), offsets_.get() + size_, offsets.get());
+            std::copy(lengths_.get(), lengths_.get() + size_, lengths.get());
+
+            kinds_    = std::move(kinds);
+            offsets_  = std::move(offsets);
+            lengths_  = std::move(lengths);
+            capacity_ = capacity;
+        }
+
+        std::unique_ptr<kind_id[]>       kinds_;
+        std::unique_ptr<std::uint32_t[]> offsets_;
+        std::unique_ptr<std::uint32_t[]> lengths_;
+        std::size_t                      size_     = 0;
+        std::size_t                      capacity_ = 0;
+        const char*                      begin_    = nullptr;
+
+        // the offset where the trivia of the first token begins
+        std::uint32_t start_ = 0;
+
+        template <class Spec>
+        friend void tokenize_all(const char* begin, const char* end, token_buffer<Spec>& buffer);
+        template <class Spec>
+        friend const char* detail::tokenize_chunk(const char* begin, const char* start,
+                                                  const char* stop, const char* end,
+                                                  token_buffer<Spec>& result);
+        template <class Spec>
+        friend void detail::stitch_chunks(const char* begin, const char* end,
+                                          token_buffer<Spec>&             buffer,
+                                          const std::vector<const char*>& starts,
+                                          const std::vector<const char*>& stops,
+                                          const token_buffer<Spec>*       chunks);
+        template <class Spec>
+        friend token_splice retokenize(const token_buffer<Spec>& old_tokens, const char* begin,
+                                       const char* end, text_edit edit,
+                                       token_buffer<Spec>& new_tokens, std::size_t lookbehind);
+        template <class Spec>
+        friend void apply_splice(token_buffer<Spec>& tokens, const token_splice& splice,
+                                 const token_buffer<Spec>& new_tokens);
+    };
+
+    template <class TokenSpec>
+    void tokenize_all(const char* begin, const char* end, token_buffer<TokenSpec>& buffer)
+    {
+        FOONATHAN_LEX_PRECONDITION(static_cast<std::uint64_t>(end - begin) <= UINT32_MAX,
+                                   "input too big for 32bit offsets");
+        FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                   "input must be null terminated");
+
+        buffer.start(begin, begin);
+        buffer.append_tokens(begin, end, end);
+    }
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_TOKEN_BUFFER_HPP_INCLUDED
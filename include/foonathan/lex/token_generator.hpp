@@ -0,0 +1,346 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_TOKEN_GENERATOR_HPP_INCLUDED
+#define FOONATHAN_LEX_TOKEN_GENERATOR_HPP_INCLUDED
+
+// whether or not C++20 coroutines are available
+#ifndef FOONATHAN_LEX_HAS_COROUTINES
+#    if defined(__cpp_impl_coroutine) && defined(__has_include)
+#        if __has_include(<coroutine>)
+#            define FOONATHAN_LEX_HAS_COROUTINES 1
+#        else
+#            define FOONATHAN_LEX_HAS_COROUTINES 0
+#        endif
+#    else
+#        define FOONATHAN_LEX_HAS_COROUTINES 0
+#    endif
+#endif
+
+#if FOONATHAN_LEX_HAS_COROUTINES
+
+#    include <coroutine>
+#    include <cstddef>
+#    include <exception>
+#    include <iterator>
+#    include <memory>
+#    include <optional>
+#    include <utility>
+
+namespace foonathan
+{
+namespace lex
+{
+    // a lazy sequence of values produced by a coroutine
+    template <class T>
+    class generator
+    {
+    public:
+        class promise_type
+        {
+        public:
+            generator get_return_object() noexcept
+            {
+                return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+            std::suspend_always final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            // the yielded object lives until the coroutine is resumed
+            std::suspend_always yield_value(const T& value) noexcept
+            {
+                value_ = std::addressof(value);
+                return {};
+            }
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception() const
+            {
+                throw;
+            }
+
+        private:
+            const T* value_ = nullptr;
+
+            friend generator;
+        };
+
+        class iterator
+        {
+        public:
+            using value_type       = T;
+            using reference        = const T&;
+            using difference_type  = std::ptrdiff_t;
+            using iterator_concept = std::input_iterator_tag;
+
+            iterator() noexcept = default;
+
+            reference operator*() const noexcept
+            {
+                return *handle_.promise().value_;
+            }
+
+            iterator& operator++()
+            {
+                handle_.resume();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& iter, std::default_sentinel_t) noexcept
+            {
+                return iter.handle_.done();
+            }
+
+        private:
+            explicit iterator(std::coroutine_handle<promise_type> handle) : handle_(handle)
+            {
+                handle_.resume();
+            }
+
+            std::coroutine_handle<promise_type> handle_;
+
+            friend generator;
+        };
+
+        generator(generator&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+        ~generator() noexcept
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        generator& operator=(generator&& other) noexcept
+        {
+            std::swap(handle_, other.handle_);
+            return *this;
+        }
+
+        // starts the coroutine, can only be called once
+        iterator begin()
+        {
+            return iterator(handle_);
+        }
+
+        std::default_sentinel_t end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        explicit generator(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle)
+        {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    namespace detail
+    {
+        template <class T, class Range>
+        generator<T> yield_each(Range range)
+        {
+            for (auto value : range)
+                co_yield value;
+        }
+    } // namespace detail
+
+    // a lazy sequence of the tokens of the tokenizers yielded by a coroutine,
+    // or of a single tokenizer
+    template <class Tokenizer>
+    class token_generator
+    {
+    public:
+        using token = decltype(std::declval<Tokenizer&>().peek());
+
+        class promise_type
+        {
+        public:
+            token_generator get_return_object() noexcept
+            {
+                return token_generator(
+                    std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+            std::suspend_always final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            // the tokenizer lives until the coroutine is resumed,
+            // which happens only once the iterator has consumed all of its tokens
+            std::suspend_always yield_value(Tokenizer& tokenizer) noexcept
+            {
+                tokenizer_ = std::addressof(tokenizer);
+                return {};
+            }
+            std::suspend_always yield_value(Tokenizer&& tokenizer) noexcept
+            {
+                tokenizer_ = std::addressof(tokenizer);
+                return {};
+            }
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception() const
+            {
+                throw;
+            }
+
+        private:
+            Tokenizer* tokenizer_ = nullptr;
+
+            friend token_generator;
+        };
+
+        class iterator
+        {
+        public:
+            using value_type       = token;
+            using reference        = token;
+            using difference_type  = std::ptrdiff_t;
+            using iterator_concept = std::input_iterator_tag;
+
+            iterator() noexcept = default;
+
+            reference operator*() const
+            {
+                return tokenizer_->peek();
+            }
+
+            iterator& operator++()
+            {
+                tokenizer_->bump();
+                if (tokenizer_->is_done())
+                    tokenizer_ = next_tokenizer(handle_, std::move(tokenizer_));
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& iter, std::default_sentinel_t) noexcept
+            {
+                return !iter.tokenizer_.has_value();
+            }
+
+        private:
+            explicit iterator(std::coroutine_handle<promise_type> handle,
+                              std::optional<Tokenizer>            tokenizer)
+            : handle_(handle), tokenizer_(std::move(tokenizer))
+            {}
+
+            // moves the tokenizer back into the coroutine and resumes it,
+            // until it yields a tokenizer with tokens left or has finished
+            static std::optional<Tokenizer> next_tokenizer(
+                std::coroutine_handle<promise_type> handle, std::optional<Tokenizer> tokenizer)
+            {
+                if (!handle)
+                    return std::nullopt;
+
+                auto& promise = handle.promise();
+                if (tokenizer)
+                    *promise.tokenizer_ = std::move(*tokenizer);
+
+                while (true)
+                {
+                    handle.resume();
+                    if (handle.done())
+                        return std::nullopt;
+                    else if (!promise.tokenizer_->is_done())
+                        return std::optional<Tokenizer>(std::move(*promise.tokenizer_));
+                }
+            }
+
+            std::coroutine_handle<promise_type> handle_;
+            // the tokens are taken from a tokenizer on the stack and not in the coroutine frame,
+            // so its state can be kept in registers,
+            // it is mutable because `peek()` isn't `const` for every tokenizer
+            mutable std::optional<Tokenizer> tokenizer_;
+
+            friend token_generator;
+        };
+
+        // yields the remaining tokens of the tokenizer without starting a coroutine
+        explicit token_generator(Tokenizer tokenizer) : tokenizer_(std::move(tokenizer)) {}
+
+        token_generator(token_generator&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)), tokenizer_(std::move(other.tokenizer_))
+        {}
+
+        ~token_generator() noexcept
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        token_generator& operator=(token_generator&& other) noexcept
+        {
+            std::swap(handle_, other.handle_);
+            std::swap(tokenizer_, other.tokenizer_);
+            return *this;
+        }
+
+        // yields the tokens one by one in a `generator` that doesn't depend on the tokenizer,
+        // this resumes a coroutine for every token
+        operator generator<token>() &&
+        {
+            return detail::yield_each<token>(std::move(*this));
+        }
+
+        // starts the coroutine, can only be called once
+        iterator begin()
+        {
+            if (handle_)
+                return iterator(handle_, iterator::next_tokenizer(handle_, std::nullopt));
+            else if (tokenizer_ && !tokenizer_->is_done())
+                return iterator(nullptr, std::exchange(tokenizer_, std::nullopt));
+            else
+                return iterator();
+        }
+
+        std::default_sentinel_t end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        explicit token_generator(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle)
+        {}
+
+        std::coroutine_handle<promise_type> handle_;
+        std::optional<Tokenizer>            tokenizer_;
+    };
+
+    // yields the remaining tokens of the tokenizer, which is moved into the generator
+    template <class Tokenizer>
+    token_generator<Tokenizer> generate_tokens(Tokenizer tokenizer)
+    {
+        return token_generator<Tokenizer>(std::move(tokenizer));
+    }
+} // namespace lex
+} // namespace foonathan
+
+#endif
+
+#endif // FOONATHAN_LEX_TOKEN_GENERATOR_HPP_INCLUDED
@@ -29,6 +29,30 @@ namespace lex
             constexpr auto index = boost::mp11::mp_find<typename TokenSpec::list, Token>::value;
             return static_cast<id_type<TokenSpec>>(index);
         }
+
+        // whether the token with a given id belongs to the category
+        template <template <typename> class Category, class TokenList>
+        struct category_table;
+        template <template <typename> class Category, class... Tokens>
+        struct category_table<Category, boost::mp11::mp_list<Tokens...>>
+        {
+            static constexpr bool value[] = {Category<Tokens>::value...};
+        };
+
+        template <template <typename> class Category, class... Tokens>
+        constexpr bool category_table<Category, boost::mp11::mp_list<Tokens...>>::value[];
+
+        // the name of the token with a given id
+        template <class TokenList>
+        struct name_table;
+        template <class... Tokens>
+        struct name_table<boost::mp11::mp_list<Tokens...>>
+        {
+            static constexpr const char* value[] = {Tokens::name...};
+        };
+
+        template <class... Tokens>
+        constexpr const char* name_table<boost::mp11::mp_list<Tokens...>>::value[];
     } // namespace token_kind_detail
 
     template <class TokenSpec>
@@ -66,7 +90,8 @@ namespace lex
         template <template <typename> class Category>
         constexpr bool is_category() const noexcept
         {
-            return is_category_impl<Category>(typename TokenSpec::list{});
+            using table = token_kind_detail::category_table<Category, typename TokenSpec::list>;
+            return table::value[id_];
         }
 
         constexpr token_kind_detail::id_type<TokenSpec> get() const noexcept
@@ -76,7 +101,7 @@ namespace lex
 
         constexpr const char* name() const noexcept
         {
-            return name_impl(typename TokenSpec::list{});
+            return token_kind_detail::name_table<typename TokenSpec::list>::value[id_];
         }
 
         friend constexpr bool operator==(token_kind lhs, token_kind rhs) noexcept
@@ -93,25 +118,6 @@ namespace lex
         : id_(id)
         {}
 
-        template <template <typename> class Category, typename... Tokens>
-        constexpr bool is_category_impl(boost::mp11::mp_list<Tokens...>) const noexcept
-        {
-            bool result  = false;
-            bool dummy[] = {(is<Tokens>() && (result = Category<Tokens>::value, true))..., true};
-            (void)dummy;
-            return result;
-        }
-
-        template <typename... Tokens>
-        constexpr const char* name_impl(boost::mp11::mp_list<Tokens...>) const noexcept
-        {
-            const char* result  = nullptr;
-            bool        dummy[] = {(is<Tokens>() && (result = Tokens::name, true))..., true};
-            (void)dummy;
-            FOONATHAN_LEX_ASSERT(result);
-            return result;
-        }
-
         token_kind_detail::id_type<TokenSpec> id_;
     };
 
@@ -0,0 +1,116 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_TOKEN_RANGE_HPP_INCLUDED
+#define FOONATHAN_LEX_TOKEN_RANGE_HPP_INCLUDED
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace foonathan
+{
+namespace lex
+{
+    // an input iterator that consumes the tokens of a tokenizer,
+    // a default constructed iterator is the end
+    template <class Tokenizer>
+    class token_iterator
+    {
+    public:
+        using value_type        = decltype(std::declval<Tokenizer&>().peek());
+        using reference         = value_type;
+        using pointer           = void;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        constexpr token_iterator() noexcept : tokenizer_(nullptr) {}
+
+        explicit constexpr token_iterator(Tokenizer& tokenizer) noexcept : tokenizer_(&tokenizer)
+        {}
+
+        constexpr reference operator*() const
+        {
+            return tokenizer_->peek();
+        }
+
+        constexpr token_iterator& operator++()
+        {
+            tokenizer_->bump();
+            return *this;
+        }
+
+        // input iterators only need `*it++` to work
+        class postfix_proxy
+        {
+        public:
+            constexpr value_type operator*() const noexcept
+            {
+                return token_;
+            }
+
+        private:
+            explicit constexpr postfix_proxy(value_type token) noexcept : token_(token) {}
+
+            value_type token_;
+
+            friend token_iterator;
+        };
+
+        constexpr postfix_proxy operator++(int)
+        {
+            return postfix_proxy(tokenizer_->get());
+        }
+
+        friend constexpr bool operator==(const token_iterator& lhs, const token_iterator& rhs)
+        {
+            return lhs.is_end() == rhs.is_end();
+        }
+
+        friend constexpr bool operator!=(const token_iterator& lhs, const token_iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        constexpr bool is_end() const
+        {
+            return tokenizer_ == nullptr || tokenizer_->is_done();
+        }
+
+        Tokenizer* tokenizer_;
+    };
+
+    // the remaining tokens of a tokenizer, iterating over it consumes them
+    template <class Tokenizer>
+    class token_range
+    {
+    public:
+        using iterator = token_iterator<Tokenizer>;
+
+        explicit constexpr token_range(Tokenizer& tokenizer) noexcept : tokenizer_(&tokenizer) {}
+
+        constexpr iterator begin() const noexcept
+        {
+            return iterator(*tokenizer_);
+        }
+
+        constexpr iterator end() const noexcept
+        {
+            return iterator();
+        }
+
+    private:
+        Tokenizer* tokenizer_;
+    };
+
+    template <class Tokenizer>
+    constexpr token_range<Tokenizer> make_token_range(Tokenizer& tokenizer) noexcept
+    {
+        return token_range<Tokenizer>(tokenizer);
+    }
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_TOKEN_RANGE_HPP_INCLUDED
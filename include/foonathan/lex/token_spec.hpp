@@ -5,6 +5,8 @@
 #ifndef FOONATHAN_LEX_TOKEN_SPEC_HPP_INCLUDED
 #define FOONATHAN_LEX_TOKEN_SPEC_HPP_INCLUDED
 
+#include <type_traits>
+
 #include <boost/mp11/list.hpp>
 
 namespace foonathan
@@ -47,6 +49,50 @@ namespace lex
     {
         using list = boost::mp11::mp_list<error_token, Tokens..., eof_token>;
     };
+
+    namespace detail
+    {
+        // whether consecutive error tokens are merged into one,
+        // can be enabled with a `static constexpr bool coalesce_errors = true` member
+        template <class TokenSpec, typename = void>
+        struct coalesce_errors : std::false_type
+        {};
+        template <class TokenSpec>
+        struct coalesce_errors<TokenSpec, decltype(void(TokenSpec::coalesce_errors))>
+        : std::integral_constant<bool, TokenSpec::coalesce_errors>
+        {};
+
+        // whether the input is followed by a null character which can be read,
+        // can be enabled with a `static constexpr bool null_terminated = true` member
+        template <class TokenSpec, typename = void>
+        struct null_terminated : std::false_type
+        {};
+        template <class TokenSpec>
+        struct null_terminated<TokenSpec, decltype(void(TokenSpec::null_terminated))>
+        : std::integral_constant<bool, TokenSpec::null_terminated>
+        {};
+
+        // whether tokens remember the whitespace tokens that were skipped before them,
+        // can be enabled with a `static constexpr bool preserve_trivia = true` member
+        template <class TokenSpec, typename = void>
+        struct preserve_trivia : std::false_type
+        {};
+        template <class TokenSpec>
+        struct preserve_trivia<TokenSpec, decltype(void(TokenSpec::preserve_trivia))>
+        : std::integral_constant<bool, TokenSpec::preserve_trivia>
+        {};
+
+        // whether the literal tokens are matched using a flat state transition table
+        // instead of a trie of template nodes,
+        // can be enabled with a `static constexpr bool flat_trie = true` member
+        template <class TokenSpec, typename = void>
+        struct flat_trie : std::false_type
+        {};
+        template <class TokenSpec>
+        struct flat_trie<TokenSpec, decltype(void(TokenSpec::flat_trie))>
+        : std::integral_constant<bool, TokenSpec::flat_trie>
+        {};
+    } // namespace detail
 } // namespace lex
 } // namespace foonathan
 
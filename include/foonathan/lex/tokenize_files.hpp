@@ -0,0 +1,245 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_TOKENIZE_FILES_HPP_INCLUDED
+#define FOONATHAN_LEX_TOKENIZE_FILES_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include <foonathan/lex/parallel_tokenize.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    struct tokenize_stats
+    {
+        std::size_t                         files  = 0;
+        std::size_t                         bytes  = 0;
+        std::size_t                         tokens = 0;
+        std::chrono::steady_clock::duration time{};
+
+        double seconds() const noexcept
+        {
+            return std::chrono::duration<double>(time).count();
+        }
+
+        double bytes_per_second() const noexcept
+        {
+            return seconds() > 0 ? static_cast<double>(bytes) / seconds() : 0.;
+        }
+
+        double tokens_per_second() const noexcept
+        {
+            return seconds() > 0 ? static_cast<double>(tokens) / seconds() : 0.;
+        }
+    };
+
+    namespace detail
+    {
+        // inputs are split or batched into jobs of roughly that size
+        constexpr std::size_t file_job_size = 256 * 1024u;
+
+        // an input that is split into chunks tokenized by different jobs
+        template <class TokenSpec>
+        struct split_file
+        {
+            std::size_t                          index;
+            std::vector<const char*>             starts;
+            std::vector<const char*>             stops;
+            std::vector<token_buffer<TokenSpec>> chunks;
+            // the job that finishes the last chunk stitches them together
+            std::atomic<std::size_t> remaining;
+
+            explicit split_file(std::size_t index, const char* begin, const char* end,
+                                std::size_t chunk_count)
+            : index(index),
+              starts(split_lines(begin, end, chunk_count)),
+              stops(chunk_count),
+              chunks(chunk_count),
+              remaining(chunk_count)
+            {}
+        };
+
+        // tokenizes the inputs [first, last) or a chunk of the split input `first`
+        template <class TokenSpec>
+        struct file_job
+        {
+            std::size_t            first, last;
+            split_file<TokenSpec>* split;
+            std::size_t            chunk;
+        };
+
+        // the jobs of one worker, the other workers steal from it when they run out of jobs
+        template <class Job>
+        class job_queue
+        {
+        public:
+            void push(Job job)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                jobs_.push_back(job);
+            }
+
+            // the owner takes the job pushed last
+            bool pop(Job& job)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (jobs_.empty())
+                    return false;
+                job = jobs_.back();
+                jobs_.pop_back();
+                return true;
+            }
+
+            // thieves take the job pushed first
+            bool steal(Job& job)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (jobs_.empty())
+                    return false;
+                job = jobs_.front();
+                jobs_.pop_front();
+                return true;
+            }
+
+        private:
+            std::mutex      mutex_;
+            std::deque<Job> jobs_;
+        };
+    } // namespace detail
+
+    template <class TokenSpec, class Input, class Callback>
+    tokenize_stats tokenize_files(const Input* inputs, std::size_t count, Callback callback,
+                                  unsigned thread_count = std::thread::hardware_concurrency())
+    {
+        using job = detail::file_job<TokenSpec>;
+
+        auto start = std::chrono::steady_clock::now();
+        if (thread_count == 0u)
+            thread_count = 1u;
+
+        tokenize_stats stats;
+        stats.files = count;
+
+        // create the jobs: big inputs are split into chunks, small inputs are batched together,
+        // the chunks of an input are spread over the workers
+        std::vector<std::unique_ptr<detail::split_file<TokenSpec>>> splits;
+        std::unique_ptr<detail::job_queue<job>[]> queues(new detail::job_queue<job>[thread_count]);
+        auto next_queue = 0u;
+        auto push       = [&](job j) {
+            queues[next_queue].push(j);
+            next_queue = (next_queue + 1u) % thread_count;
+        };
+
+        auto batch_first = std::size_t(0);
+        auto batch_size  = std::size_t(0);
+        for (auto i = std::size_t(0); i != count; ++i)
+        {
+            auto begin = inputs[i].data();
+            auto size  = static_cast<std::size_t>(inputs[i].size());
+            FOONATHAN_LEX_PRECONDITION(static_cast<std::uint64_t>(size) <= UINT32_MAX,
+                                       "input too big for 32bit offsets");
+            FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value
+                                           || begin[size] == '\0',
+                                       "input must be null terminated");
+            stats.bytes += size;
+
+            if (thread_count > 1u && size >= 2 * detail::file_job_size)
+            {
+                if (batch_first != i)
+                    push(job{batch_first, i, nullptr, 0});
+
+                auto chunk_count = size / detail::file_job_size;
+                splits.emplace_back(
+                    new detail::split_file<TokenSpec>(i, begin, begin + size, chunk_count));
+                for (auto chunk = std::size_t(0); chunk != chunk_count; ++chunk)
+                    push(job{i, i + 1u, splits.back().get(), chunk});
+
+                batch_first = i + 1u;
+                batch_size  = 0;
+            }
+            else if ((batch_size += size) >= detail::file_job_size)
+            {
+                push(job{batch_first, i + 1u, nullptr, 0});
+                batch_first = i + 1u;
+                batch_size  = 0;
+            }
+        }
+        if (batch_first != count)
+            push(job{batch_first, count, nullptr, 0});
+
+        // each worker reuses its own token buffer for the inputs of its batches,
+        // chunks are tokenized into the buffers of the split input
+        std::vector<std::size_t> token_counts(thread_count);
+        auto                     work = [&](unsigned worker) {
+            token_buffer<TokenSpec> buffer;
+            auto                    tokens = std::size_t(0);
+
+            job j;
+            while (true)
+            {
+                auto found = queues[worker].pop(j);
+                for (auto i = 1u; !found && i != thread_count; ++i)
+                    found = queues[(worker + i) % thread_count].steal(j);
+                if (!found)
+                    // no jobs are created after starting, so everything is done
+                    break;
+
+                if (j.split)
+                {
+                    auto& split = *j.split;
+                    auto  begin = inputs[j.first].data();
+                    auto  end   = begin + inputs[j.first].size();
+
+                    split.stops[j.chunk]
+                        = detail::tokenize_chunk(begin, split.starts[j.chunk],
+                                                 split.starts[j.chunk + 1u], end,
+                                                 split.chunks[j.chunk]);
+                    if (split.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1u)
+                    {
+                        auto& result = split.chunks.front();
+                        detail::stitch_chunks(begin, end, result, split.starts, split.stops,
+                                              split.chunks.data());
+                        tokens += result.size();
+                        callback(split.index, static_cast<const token_buffer<TokenSpec>&>(result));
+                        split.chunks.clear();
+                    }
+                }
+                else
+                {
+                    for (auto i = j.first; i != j.last; ++i)
+                    {
+                        auto begin = inputs[i].data();
+                        tokenize_all(begin, begin + inputs[i].size(), buffer);
+                        tokens += buffer.size();
+                        callback(i, static_cast<const token_buffer<TokenSpec>&>(buffer));
+                    }
+                }
+            }
+
+            token_counts[worker] = tokens;
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count - 1u);
+        for (auto i = 1u; i != thread_count; ++i)
+            threads.emplace_back(work, i);
+        work(0u);
+        for (auto& thread : threads)
+            thread.join();
+
+        for (auto tokens : token_counts)
+            stats.tokens += tokens;
+        stats.time = std::chrono::steady_clock::now() - start;
+        return stats;
+    }
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_TOKENIZE_FILES_HPP_INCLUDED
@@ -5,7 +5,10 @@
 #ifndef FOONATHAN_LEX_TOKENIZER_HPP_INCLUDED
 #define FOONATHAN_LEX_TOKENIZER_HPP_INCLUDED
 
+#include <foonathan/lex/detail/keyword_hash.hpp>
+#include <foonathan/lex/detail/keyword_scan.hpp>
 #include <foonathan/lex/detail/trie.hpp>
+#include <foonathan/lex/detail/trie_table.hpp>
 #include <foonathan/lex/identifier_token.hpp>
 #include <foonathan/lex/literal_token.hpp>
 #include <foonathan/lex/rule_token.hpp>
@@ -37,8 +40,15 @@ namespace lex
         };
 
         template <class TokenSpec, class LiteralTokens>
-        using literal_trie =
-            typename mp::mp_apply_q<literal_trie_impl<TokenSpec>, LiteralTokens>::type;
+        using literal_trie = typename trie<TokenSpec>::template compress<
+            typename mp::mp_apply_q<literal_trie_impl<TokenSpec>, LiteralTokens>::type>;
+
+        // the literal trie or its flat table, depending on the token spec
+        template <class TokenSpec, class LiteralTokens>
+        using literal_matcher
+            = mp::mp_eval_if_c<flat_trie<TokenSpec>::value,
+                               trie_table<TokenSpec, LiteralTokens, mp::mp_list<>>, literal_trie,
+                               TokenSpec, LiteralTokens>;
 
         //=== rule insertion ===//
         template <class TokenSpec, class Trie>
@@ -65,32 +75,67 @@ namespace lex
         template <class TokenSpec, class Identifier, class... Keywords>
         struct keyword_identifier_matcher
         {
-            using keyword_trie = literal_trie<TokenSpec, mp::mp_list<Keywords...>>;
+            using keyword_hash = detail::keyword_hash<TokenSpec, Keywords...>;
 
             static constexpr bool is_conflicting_literal(token_kind<TokenSpec> kind) noexcept
             {
                 return Identifier::is_conflicting_literal(kind);
             }
 
+            static constexpr bool can_start(char c) noexcept
+            {
+                return Identifier::can_start(c);
+            }
+
             static constexpr match_result<TokenSpec> try_match(const char* str,
                                                                const char* end) noexcept
+            {
+                return try_match(has_identifier_shape<TokenSpec, Identifier>{}, str, end);
+            }
+
+        private:
+            static constexpr match_result<TokenSpec> try_match(std::true_type, const char* str,
+                                                               const char* end) noexcept
+            {
+                // match the identifier and the keywords at the same time
+                return keyword_scan<TokenSpec, Identifier, Keywords...>::try_match(str, end);
+            }
+            static constexpr match_result<TokenSpec> try_match(std::false_type, const char* str,
+                                                               const char* end) noexcept
             {
                 auto identifier = Identifier::try_match(str, end);
                 if (!identifier.is_success())
                     // not an identifier, so can't be a keyword
                     return identifier;
 
-                // try to match a keyword in the identifier
-                auto identifier_begin = str;
-                auto identifier_end   = str + identifier.bump;
-                auto keyword          = keyword_trie::try_match(identifier_begin, identifier_end);
-                if (keyword.is_success() && keyword.bump == identifier.bump)
-                    // we've matched a keyword and it isn't a prefix but the whole string
+                // check whether the identifier is a keyword
+                auto keyword
+                    = match_keyword(std::integral_constant<bool, keyword_hash::is_valid>{}, str,
+                                    identifier.bump);
+                if (keyword.is_success())
                     return keyword;
                 else
-                    // didn't match keyword or it was only a prefix
                     return identifier;
             }
+
+            static constexpr match_result<TokenSpec> match_keyword(std::true_type, const char* str,
+                                                                   std::size_t length) noexcept
+            {
+                return keyword_hash::try_match(str, length);
+            }
+            static constexpr match_result<TokenSpec> match_keyword(std::false_type, const char* str,
+                                                                   std::size_t length) noexcept
+            {
+                // no perfect hash function for the keywords, use a trie instead
+                using keyword_trie = literal_matcher<TokenSpec, mp::mp_list<Keywords...>>;
+
+                auto keyword = keyword_trie::try_match(str, str + length);
+                if (keyword.is_success() && keyword.bump == length)
+                    // we've matched a keyword and it isn't a prefix but the whole string
+                    return keyword;
+                else
+                    return match_result<TokenSpec>::unmatched();
+            }
         };
 
         template <class TokenSpec, class KeywordList>
@@ -109,17 +154,20 @@ namespace lex
             using fn = mp::mp_list<mp::mp_apply_q<matcher<Identifiers>, KeywordList>...>;
         };
 
+        // the list of rules, one for each identifier
+        template <class TokenSpec, class Identifiers, class Keywords>
+        using keyword_rules = mp::mp_apply_q<keyword_trie_impl<TokenSpec, Keywords>, Identifiers>;
+
         template <class TokenSpec, class Trie, class Identifiers, class Keywords>
         using keyword_trie
-            = rule_trie<TokenSpec, Trie,
-                        // insert the list of rules
-                        mp::mp_apply_q<keyword_trie_impl<TokenSpec, Keywords>, Identifiers>>;
+            = rule_trie<TokenSpec, Trie, keyword_rules<TokenSpec, Identifiers, Keywords>>;
 
         //=== token_spec_trie ===//
-        template <class TokenSpec>
+        // the trie of the given tokens, which are a subset of the tokens in the token spec
+        template <class TokenSpec, class TokenList = typename TokenSpec::list>
         struct token_spec_trie_impl
         {
-            using list = typename TokenSpec::list;
+            using list = TokenList;
 
             // split the tokens
             using identifiers = mp::mp_copy_if<list, is_identifier_token>;
@@ -133,22 +181,134 @@ namespace lex
             static_assert(mp::mp_empty<keywords>::value || mp::mp_size<identifiers>::value > 0,
                           "keywords require an identifier");
 
-            // start with the literal trie
-            using trie0 = literal_trie<TokenSpec, literals>;
-            // insert all rule tokens
-            using trie1 = rule_trie<TokenSpec, trie0, rule_tokens>;
-            // insert the keyword identifier rule
-            using trie2 = keyword_trie<TokenSpec, trie1, identifiers, keywords>;
+            template <class Literals>
+            struct template_backend
+            {
+                // start with the literal trie
+                using trie0 = literal_trie<TokenSpec, Literals>;
+                // insert all rule tokens
+                using trie1 = rule_trie<TokenSpec, trie0, rule_tokens>;
+                // insert the keyword identifier rule
+                using type = keyword_trie<TokenSpec, trie1, identifiers, keywords>;
+            };
+
+            template <class Literals>
+            struct table_backend
+            {
+                // the rules in the order the template trie tries them:
+                // each rule token is pushed in front of the following ones, the keyword rule last
+                using rules = mp::mp_append<mp::mp_reverse<rule_tokens>,
+                                            keyword_rules<TokenSpec, identifiers, keywords>>;
+                using type  = trie_table<TokenSpec, Literals, rules>;
+            };
+
+            using trie = typename std::conditional_t<detail::flat_trie<TokenSpec>::value,
+                                                     table_backend<literals>,
+                                                     template_backend<literals>>::type;
         };
 
-        template <class TokenSpec>
-        using token_spec_trie = typename token_spec_trie_impl<TokenSpec>::trie2;
+        template <class TokenSpec, class TokenList = typename TokenSpec::list>
+        using token_spec_trie = typename token_spec_trie_impl<TokenSpec, TokenList>::trie;
+
+        //=== start characters ===//
+        template <class Token>
+        constexpr bool can_start_token(std::true_type /* literal */, std::false_type, char c)
+        {
+            return Token::value[0] == c;
+        }
+        template <class Token>
+        constexpr bool can_start_token(std::false_type, std::true_type /* rule */, char c)
+        {
+            return Token::can_start(c);
+        }
+        template <class Token>
+        constexpr bool can_start_token(std::false_type, std::false_type, char)
+        {
+            // special tokens or null tokens, keywords are handled by the identifier
+            return false;
+        }
+
+        // whether or not some token can start with a character
+        template <class TokenList>
+        struct start_char_table
+        {
+            bool table[256];
+
+            constexpr start_char_table() noexcept : table{}
+            {
+                for (auto i = 0u; i != 256u; ++i)
+                    table[i] = can_start(TokenList{}, static_cast<char>(i));
+            }
+
+            template <class... Tokens>
+            static constexpr bool can_start(mp::mp_list<Tokens...>, char c) noexcept
+            {
+                auto result  = false;
+                bool dummy[] = {(result = result
+                                          || can_start_token<Tokens>(
+                                              is_non_keyword_literal_token<Tokens>{},
+                                              is_rule_token<Tokens>{}, c),
+                                 true)...,
+                                true};
+                (void)dummy;
+                return result;
+            }
+        };
+
+        template <class TokenList>
+        struct start_char_storage
+        {
+            static constexpr start_char_table<TokenList> table{};
+        };
+
+        template <class TokenList>
+        constexpr start_char_table<TokenList> start_char_storage<TokenList>::table;
+
+        //=== token_spec_matcher ===//
+        // matches a single token at the given position
+        template <class TokenSpec, class TokenList = typename TokenSpec::list>
+        struct token_spec_matcher
+        {
+            using trie = token_spec_trie<TokenSpec, TokenList>;
+
+            static constexpr match_result<TokenSpec> try_match(const char* str,
+                                                               const char* end) noexcept
+            {
+                auto result = trie::try_match(str, end);
+                if (result.is_error())
+                    return finish_error(coalesce_errors<TokenSpec>{}, result, str, end);
+                else
+                    return result;
+            }
+
+        private:
+            static constexpr match_result<TokenSpec> finish_error(std::false_type,
+                                                                  match_result<TokenSpec> result,
+                                                                  const char*,
+                                                                  const char*) noexcept
+            {
+                return result;
+            }
+            static constexpr match_result<TokenSpec> finish_error(std::true_type,
+                                                                  match_result<TokenSpec> result,
+                                                                  const char* str,
+                                                                  const char* end) noexcept
+            {
+                // skip until a character where a token could start
+                auto& starts = start_char_storage<TokenList>::table;
+                auto  cur    = str + result.bump;
+                while (!at_end(cur, end) && !starts.table[static_cast<unsigned char>(*cur)])
+                    ++cur;
+                return match_result<TokenSpec>::error(static_cast<std::size_t>(cur - str));
+            }
+        };
     } // namespace detail
 
     template <class TokenSpec>
     class tokenizer
     {
-        using trie = detail::token_spec_trie<TokenSpec>;
+        using matcher          = detail::token_spec_matcher<TokenSpec>;
+        using trivia_begin_ptr = detail::trivia_begin<detail::preserve_trivia<TokenSpec>::value>;
         static_assert(detail::mp::mp_all_of<typename TokenSpec::list, is_token>::value,
                       "invalid types in token specifications");
 
@@ -159,8 +319,14 @@ namespace lex
         {}
 
         explicit constexpr tokenizer(const char* begin, const char* end)
-        : begin_(begin), ptr_(begin), end_(end), last_result_(match_result<TokenSpec>::unmatched())
+        : begin_(begin),
+          ptr_(begin),
+          end_(end),
+          trivia_begin_(begin),
+          last_result_(match_result<TokenSpec>::unmatched())
         {
+            FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                       "input must be null terminated");
             bump();
         }
 
@@ -171,7 +337,8 @@ namespace lex
         //=== tokenizer functions ===//
         constexpr token<TokenSpec> peek() const noexcept
         {
-            return token<TokenSpec>(last_result_.kind, ptr_, last_result_.bump);
+            return detail::token_factory::make(last_result_.kind, ptr_, last_result_.bump,
+                                               trivia_begin_.size(ptr_));
         }
 
         constexpr bool is_done() const noexcept
@@ -195,6 +362,7 @@ namespace lex
         constexpr void reset(const char* position) noexcept
         {
             reset_impl(position);
+            trivia_begin_.set(position);
 
             using any_whitespace
                 = detail::mp::mp_any_of<typename TokenSpec::list, is_whitespace_token>;
@@ -224,7 +392,7 @@ namespace lex
             FOONATHAN_LEX_PRECONDITION(begin_ <= position && position <= end_,
                                        "position out of range");
             ptr_         = position;
-            last_result_ = trie::try_match(ptr_, end_);
+            last_result_ = matcher::try_match(ptr_, end_);
         }
 
         constexpr void skip_whitespace(std::true_type)
@@ -234,9 +402,10 @@ namespace lex
         }
         constexpr void skip_whitespace(std::false_type) {}
 
-        const char* begin_{};
-        const char* ptr_{};
-        const char* end_{};
+        const char*      begin_{};
+        const char*      ptr_{};
+        const char*      end_{};
+        trivia_begin_ptr trivia_begin_;
 
         match_result<TokenSpec> last_result_;
     };
@@ -0,0 +1,88 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_TRIVIA_TOKENIZER_HPP_INCLUDED
+#define FOONATHAN_LEX_TRIVIA_TOKENIZER_HPP_INCLUDED
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    // tokenizes the leading trivia of a token, i.e. the whitespace tokens before it
+    template <class TokenSpec>
+    class trivia_tokenizer
+    {
+        using matcher = detail::token_spec_matcher<TokenSpec>;
+        static_assert(detail::preserve_trivia<TokenSpec>::value,
+                      "token spec doesn't preserve trivia");
+
+    public:
+        //=== constructors ===//
+        // `end` is the end of the entire input the token was matched in
+        explicit constexpr trivia_tokenizer(const token<TokenSpec>& token, const char* end)
+        : ptr_(token.leading_trivia().data()),
+          end_(end),
+          token_(token),
+          last_result_(match_result<TokenSpec>::unmatched())
+        {
+            FOONATHAN_LEX_PRECONDITION(!detail::null_terminated<TokenSpec>::value || *end == '\0',
+                                       "input must be null terminated");
+            match();
+        }
+
+        //=== tokenizer functions ===//
+        constexpr token<TokenSpec> peek() const noexcept
+        {
+            if (is_done())
+                return token_;
+            else
+                return detail::token_factory::make(last_result_.kind, ptr_, last_result_.bump);
+        }
+
+        constexpr bool is_done() const noexcept
+        {
+            return ptr_ == token_.spelling().data();
+        }
+
+        constexpr token<TokenSpec> get() noexcept
+        {
+            auto result = peek();
+            bump();
+            return result;
+        }
+
+        constexpr void bump() noexcept
+        {
+            if (!is_done())
+            {
+                ptr_ += last_result_.bump;
+                match();
+            }
+        }
+
+    private:
+        constexpr void match() noexcept
+        {
+            if (!is_done())
+            {
+                last_result_ = matcher::try_match(ptr_, end_);
+                FOONATHAN_LEX_ASSERT(
+                    last_result_.kind.template is_category<is_whitespace_token>()
+                    && last_result_.bump <= static_cast<std::size_t>(token_.spelling().data()
+                                                                     - ptr_));
+            }
+        }
+
+        const char*      ptr_;
+        const char*      end_;
+        token<TokenSpec> token_;
+
+        match_result<TokenSpec> last_result_;
+    };
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_TRIVIA_TOKENIZER_HPP_INCLUDED
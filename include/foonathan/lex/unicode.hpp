@@ -0,0 +1,206 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_UNICODE_HPP_INCLUDED
+#define FOONATHAN_LEX_UNICODE_HPP_INCLUDED
+
+#include <foonathan/lex/detail/unicode_tables.hpp>
+#include <foonathan/lex/rule_token.hpp>
+
+namespace foonathan
+{
+namespace lex
+{
+    namespace unicode
+    {
+        namespace detail
+        {
+            constexpr bool xid_lookup(const std::uint32_t* blocks, char32_t cp) noexcept
+            {
+                auto block = xid_tables<>::stage1[cp >> 8];
+                auto word  = blocks[block * 8u + ((cp >> 5) & 0x7u)];
+                return (word >> (cp & 0x1Fu)) & 1u;
+            }
+
+            constexpr bool is_continuation(char c) noexcept
+            {
+                return (static_cast<unsigned char>(c) & 0xC0u) == 0x80u;
+            }
+        } // namespace detail
+
+        constexpr bool is_ascii(char32_t cp) noexcept
+        {
+            return cp <= 0x7F;
+        }
+
+        constexpr bool is_xid_start(char32_t cp) noexcept
+        {
+            if (is_ascii(cp))
+                return ascii::is_alpha(static_cast<char>(cp));
+            else if (cp < detail::xid_table_limit)
+                return detail::xid_lookup(detail::xid_tables<>::start, cp);
+            else
+                return false;
+        }
+
+        constexpr bool is_xid_continue(char32_t cp) noexcept
+        {
+            if (is_ascii(cp))
+                return ascii::is_alnum(static_cast<char>(cp)) || cp == '_';
+            else if (cp < detail::xid_table_limit)
+                return detail::xid_lookup(detail::xid_tables<>::continue_, cp);
+            else
+                return cp >= 0xE0100 && cp <= 0xE01EF;
+        }
+
+        struct decode_result
+        {
+            char32_t    code_point;
+            std::size_t length; // zero if the input is ill-formed
+        };
+
+        // decodes the UTF-8 encoded code point at the beginning of [cur, end),
+        // overlong encodings, surrogates and truncated sequences are ill-formed
+        constexpr decode_result decode_utf8(const char* cur, const char* end) noexcept
+        {
+            if (lex::detail::at_end(cur, end))
+                return {0, 0};
+
+            auto lead = static_cast<unsigned char>(*cur);
+            if (lead < 0x80u)
+                return {lead, 1};
+
+            auto length = std::size_t(0);
+            auto cp     = char32_t(0);
+            auto min_cp = char32_t(0);
+            if ((lead & 0xE0u) == 0xC0u)
+            {
+                length = 2;
+                cp     = lead & 0x1Fu;
+                min_cp = 0x80;
+            }
+            else if ((lead & 0xF0u) == 0xE0u)
+            {
+                length = 3;
+                cp     = lead & 0x0Fu;
+                min_cp = 0x800;
+            }
+            else if ((lead & 0xF8u) == 0xF0u)
+            {
+                length = 4;
+                cp     = lead & 0x07u;
+                min_cp = 0x10000;
+            }
+            else
+                // a continuation byte or an invalid lead byte
+                return {0, 0};
+
+            if (static_cast<std::size_t>(end - cur) < length)
+            {
+                lex::detail::report_reached_end();
+                return {0, 0};
+            }
+            for (auto i = std::size_t(1); i != length; ++i)
+            {
+                if (!detail::is_continuation(cur[i]))
+                    return {0, 0};
+                cp = (cp << 6) | (static_cast<unsigned char>(cur[i]) & 0x3Fu);
+            }
+
+            if (cp < min_cp || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+                return {0, 0};
+            return {cp, length};
+        }
+    } // namespace unicode
+
+    namespace token_rule
+    {
+        namespace detail
+        {
+            template <typename Predicate>
+            struct code_point_predicate : base_rule
+            {
+                Predicate p;
+
+                constexpr code_point_predicate(Predicate p) noexcept : p(p) {}
+
+                template <class End>
+                constexpr bool try_match(const char*& cur, End end) const noexcept
+                {
+                    auto result = unicode::decode_utf8(cur, end);
+                    if (result.length > 0u && p(result.code_point))
+                    {
+                        cur += result.length;
+                        return true;
+                    }
+                    else
+                        return false;
+                }
+
+                constexpr bool can_start(char first) const noexcept
+                {
+                    // we can't know for non-ASCII characters without decoding
+                    return !ascii::is_ascii(first) || p(static_cast<char32_t>(first));
+                }
+
+                constexpr bool is_nullable() const noexcept
+                {
+                    return false;
+                }
+            };
+
+            // the character class of the ASCII characters of one of the `lex::unicode` predicates
+            template <typename Predicate>
+            constexpr lex::detail::simd_char_class unicode_simd_class_of(std::false_type,
+                                                                         Predicate) noexcept
+            {
+                return lex::detail::simd_char_class::none;
+            }
+            template <typename Predicate>
+            constexpr lex::detail::simd_char_class unicode_simd_class_of(std::true_type,
+                                                                         Predicate p) noexcept
+            {
+                using fn_ptr = bool (*)(char32_t);
+                if (static_cast<fn_ptr>(p) == static_cast<fn_ptr>(&unicode::is_xid_continue))
+                    return lex::detail::simd_char_class::identifier;
+                else
+                    return lex::detail::simd_char_class::none;
+            }
+
+            template <typename Predicate, class End>
+            constexpr void match_star(const code_point_predicate<Predicate>& r, const char*& cur,
+                                      End end) noexcept
+            {
+                auto cls = unicode_simd_class_of(std::is_convertible<Predicate,
+                                                                     bool (*)(char32_t)>{},
+                                                 r.p);
+                if (cls == lex::detail::simd_char_class::none
+                    || lex::detail::is_constant_evaluated())
+                {
+                    while (r.try_match(cur, end))
+                    {
+                    }
+                    return;
+                }
+
+                // skip blocks of ASCII characters at once,
+                // only the others and the remaining ones are decoded
+                do
+                {
+                    cur = lex::detail::simd_skip_class(cls, cur, end);
+                } while (r.try_match(cur, end));
+            }
+        } // namespace detail
+
+        // matches a single UTF-8 encoded code point that satisfies the predicate `bool(char32_t)`
+        template <typename Predicate>
+        constexpr detail::code_point_predicate<Predicate> code_point(Predicate p) noexcept
+        {
+            return {p};
+        }
+    } // namespace token_rule
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_UNICODE_HPP_INCLUDED
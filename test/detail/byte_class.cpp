@@ -0,0 +1,86 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/detail/byte_class.hpp>
+
+#include <doctest.h>
+
+#include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/rule_token.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct plus, struct plus_eq, struct one, struct number,
+                                  struct whitespace>;
+
+struct plus : FOONATHAN_LEX_LITERAL("+")
+{};
+struct plus_eq : FOONATHAN_LEX_LITERAL("+=")
+{};
+struct one : FOONATHAN_LEX_LITERAL("1")
+{};
+
+struct number : lex::rule_token<number, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_digit);
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+template <class... Ts>
+using list = lex::detail::mp::mp_list<Ts...>;
+} // namespace
+
+TEST_CASE("detail::byte_class_map")
+{
+    SUBCASE("empty")
+    {
+        constexpr auto map = lex::detail::byte_class_map<list<>, list<>>{};
+        static_assert(map.count() == 1u, "");
+        for (auto i = 0; i != 256; ++i)
+            REQUIRE(map[static_cast<char>(i)] == 0u);
+    }
+    SUBCASE("literals")
+    {
+        constexpr auto map = lex::detail::byte_class_map<list<plus, plus_eq>, list<>>{};
+        static_assert(map.count() == 3u, "");
+        REQUIRE(map['+'] != map['=']);
+        REQUIRE(map['+'] != map['a']);
+        REQUIRE(map['='] != map['a']);
+        REQUIRE(map['a'] == map['\0']);
+        REQUIRE(map['a'] == map['\xFF']);
+    }
+    SUBCASE("literals and rules")
+    {
+        constexpr auto map
+            = lex::detail::byte_class_map<list<plus, plus_eq, one>, list<number, whitespace>>{};
+        // '+', '=', '1', the other digits, whitespace and the rest
+        static_assert(map.count() == 6u, "");
+        REQUIRE(map['1'] != map['0']);
+        for (auto c : "023456789")
+            if (c)
+                REQUIRE(map[c] == map['0']);
+        for (auto c : " \t\n\r\f\v")
+            if (c)
+                REQUIRE(map[c] == map[' ']);
+        REQUIRE(map[' '] != map['0']);
+        REQUIRE(map[' '] != map['a']);
+        REQUIRE(map['0'] != map['a']);
+        REQUIRE(map['a'] == map['@']);
+
+        for (auto i = 0; i != 256; ++i)
+            REQUIRE(map[static_cast<char>(i)] < map.count());
+    }
+}
@@ -0,0 +1,247 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/detail/keyword_hash.hpp>
+
+#include <doctest.h>
+#include <cstring>
+#include <string>
+
+#include <boost/mp11/algorithm.hpp>
+
+#include <foonathan/lex/identifier_token.hpp>
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+// actual types don't matter for the hash, just the id
+using c_tokens
+    = lex::token_spec<struct k_auto, struct k_break, struct k_case, struct k_char, struct k_const,
+                      struct k_continue, struct k_default, struct k_do, struct k_double,
+                      struct k_else, struct k_enum, struct k_extern, struct k_float, struct k_for,
+                      struct k_goto, struct k_if, struct k_int, struct k_long, struct k_register,
+                      struct k_return, struct k_short, struct k_signed, struct k_sizeof,
+                      struct k_static, struct k_struct, struct k_switch, struct k_typedef,
+                      struct k_union, struct k_unsigned, struct k_void, struct k_volatile,
+                      struct k_while>;
+
+#define KEYWORD(Name)                                                                              \
+    struct k_##Name : FOONATHAN_LEX_KEYWORD(#Name)                                                 \
+    {};
+
+KEYWORD(auto)
+KEYWORD(break)
+KEYWORD(case)
+KEYWORD(char)
+KEYWORD(const)
+KEYWORD(continue)
+KEYWORD(default)
+KEYWORD(do)
+KEYWORD(double)
+KEYWORD(else)
+KEYWORD(enum)
+KEYWORD(extern)
+KEYWORD(float)
+KEYWORD(for)
+KEYWORD(goto)
+KEYWORD(if)
+KEYWORD(int)
+KEYWORD(long)
+KEYWORD(register)
+KEYWORD(return)
+KEYWORD(short)
+KEYWORD(signed)
+KEYWORD(sizeof)
+KEYWORD(static)
+KEYWORD(struct)
+KEYWORD(switch)
+KEYWORD(typedef)
+KEYWORD(union)
+KEYWORD(unsigned)
+KEYWORD(void)
+KEYWORD(volatile)
+KEYWORD(while)
+
+#undef KEYWORD
+
+// the keywords of the spec, without the error and EOF token
+template <class Spec>
+using spec_keywords = boost::mp11::mp_pop_front<boost::mp11::mp_reverse<
+    boost::mp11::mp_pop_front<boost::mp11::mp_reverse<typename Spec::list>>>>;
+
+template <class Spec, class Keywords = spec_keywords<Spec>>
+struct spec_hash_impl;
+template <class Spec, class... Keywords>
+struct spec_hash_impl<Spec, boost::mp11::mp_list<Keywords...>>
+{
+    using type = lex::detail::keyword_hash<Spec, Keywords...>;
+};
+
+template <class Spec>
+using spec_hash = typename spec_hash_impl<Spec>::type;
+
+template <class Hash>
+bool is_keyword(Hash, const char* str)
+{
+    return Hash::try_match(str, std::strlen(str)).is_success();
+}
+
+template <typename T, class Hash>
+void verify(Hash, const char* str)
+{
+    auto result = Hash::try_match(str, std::strlen(str));
+    REQUIRE(result.is_success());
+    REQUIRE(result.bump == std::strlen(str));
+    REQUIRE(result.kind.template is<T>());
+}
+
+constexpr auto test_lookup()
+{
+    return spec_hash<c_tokens>::try_match("continue", 8).kind;
+}
+
+// the same length, first and last character
+using similar_tokens = lex::token_spec<struct alter, struct after, struct aster>;
+struct alter : FOONATHAN_LEX_KEYWORD("alter")
+{};
+struct after : FOONATHAN_LEX_KEYWORD("after")
+{};
+struct aster : FOONATHAN_LEX_KEYWORD("aster")
+{};
+
+// can't be told apart by the first and last four characters
+using long_tokens = lex::token_spec<struct long_a, struct long_b>;
+struct long_a : FOONATHAN_LEX_KEYWORD("abcd_a_efgh")
+{};
+struct long_b : FOONATHAN_LEX_KEYWORD("abcd_b_efgh")
+{};
+
+// many generated keywords, the number written in base 26 with letters as digits
+template <std::size_t Value>
+struct numbered_keyword_base
+: lex::keyword_token<'k', char('a' + Value / 26 / 26), char('a' + Value / 26 % 26),
+                     char('a' + Value % 26)>
+{};
+
+template <class I>
+struct numbered_keyword : numbered_keyword_base<I::value * 7>
+{};
+
+using many_tokens = boost::mp11::mp_rename<
+    boost::mp11::mp_transform<numbered_keyword, boost::mp11::mp_iota_c<128>>, lex::token_spec>;
+} // namespace
+
+TEST_CASE("detail::keyword_hash")
+{
+    SUBCASE("C keywords")
+    {
+        using hash = spec_hash<c_tokens>;
+        static_assert(hash::is_valid, "");
+
+        verify<k_auto>(hash{}, "auto");
+        verify<k_const>(hash{}, "const");
+        verify<k_continue>(hash{}, "continue");
+        verify<k_do>(hash{}, "do");
+        verify<k_double>(hash{}, "double");
+        verify<k_if>(hash{}, "if");
+        verify<k_int>(hash{}, "int");
+        verify<k_unsigned>(hash{}, "unsigned");
+        verify<k_volatile>(hash{}, "volatile");
+        verify<k_while>(hash{}, "while");
+
+        REQUIRE(!is_keyword(hash{}, ""));
+        REQUIRE(!is_keyword(hash{}, "i"));
+        REQUIRE(!is_keyword(hash{}, "in"));
+        REQUIRE(!is_keyword(hash{}, "integer"));
+        REQUIRE(!is_keyword(hash{}, "contimue"));
+        REQUIRE(!is_keyword(hash{}, "Continue"));
+        REQUIRE(!is_keyword(hash{}, "continue_"));
+        REQUIRE(!is_keyword(hash{}, "a_very_long_identifier_that_is_longer_than_all"));
+
+        constexpr auto result = test_lookup();
+        REQUIRE(result.is<k_continue>());
+    }
+    SUBCASE("similar keywords")
+    {
+        using hash = spec_hash<similar_tokens>;
+        static_assert(hash::is_valid, "");
+
+        verify<alter>(hash{}, "alter");
+        verify<after>(hash{}, "after");
+        verify<aster>(hash{}, "aster");
+        REQUIRE(!is_keyword(hash{}, "abter"));
+    }
+    SUBCASE("many keywords")
+    {
+        using hash = spec_hash<many_tokens>;
+        static_assert(hash::is_valid, "");
+
+        for (auto i = 0u; i != 128u; ++i)
+        {
+            auto value   = i * 7u;
+            char str[]   = {'k', char('a' + value / 26 / 26), char('a' + value / 26 % 26),
+                          char('a' + value % 26), '\0'};
+            auto result = hash::try_match(str, 4);
+            INFO(str);
+            REQUIRE(result.is_success());
+            REQUIRE(result.kind.get() == i + 1u);
+        }
+        REQUIRE(!is_keyword(hash{}, "kaab"));
+        REQUIRE(!is_keyword(hash{}, "kzzz"));
+    }
+    SUBCASE("no perfect hash")
+    {
+        using hash = spec_hash<long_tokens>;
+        static_assert(!hash::is_valid, "");
+    }
+}
+
+namespace
+{
+template <class Keywords>
+struct test_spec;
+
+template <class Keywords>
+struct identifier : lex::identifier_token<identifier<Keywords>, test_spec<Keywords>>
+{
+    static constexpr auto rule() noexcept
+    {
+        // not of the shape `head + star(tail)`, so the keywords are matched after the identifier
+        namespace tr = lex::token_rule;
+        return tr::plus(tr::r('_') / lex::ascii::is_alpha) + tr::opt(tr::r('!'));
+    }
+};
+
+template <class Keywords>
+struct test_spec
+: boost::mp11::mp_rename<boost::mp11::mp_push_front<Keywords, identifier<Keywords>>,
+                         lex::token_spec>
+{};
+
+template <class Keywords>
+lex::token_kind<test_spec<Keywords>> match(const char* str)
+{
+    using matcher = lex::detail::token_spec_matcher<test_spec<Keywords>>;
+    auto result   = matcher::try_match(str, str + std::strlen(str));
+    REQUIRE(result.bump == std::strlen(str));
+    return result.kind;
+}
+} // namespace
+
+TEST_CASE("detail::keyword_hash in tokenizer")
+{
+    using c_keywords = spec_keywords<c_tokens>;
+    REQUIRE(match<c_keywords>("continue").is(k_continue{}));
+    REQUIRE(match<c_keywords>("cont").is(identifier<c_keywords>{}));
+    REQUIRE(match<c_keywords>("continues").is(identifier<c_keywords>{}));
+
+    // falls back to the trie
+    using long_keywords = boost::mp11::mp_list<long_a, long_b>;
+    REQUIRE(match<long_keywords>("abcd_a_efgh").is(long_a{}));
+    REQUIRE(match<long_keywords>("abcd_b_efgh").is(long_b{}));
+    REQUIRE(match<long_keywords>("abcd_c_efgh").is(identifier<long_keywords>{}));
+    REQUIRE(match<long_keywords>("abcd_a_efg").is(identifier<long_keywords>{}));
+}
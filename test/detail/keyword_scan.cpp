@@ -0,0 +1,165 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/detail/keyword_scan.hpp>
+
+#include <doctest.h>
+#include <cstring>
+
+#include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/identifier_token.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct identifier, struct kw_do, struct kw_double, struct kw_if,
+                                  struct kw_int, struct kw_x_y, struct kw_dash>;
+
+struct identifier : lex::identifier_token<identifier, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        namespace tr = lex::token_rule;
+        return (tr::r('_') / lex::ascii::is_alpha) + tr::star(tr::r('_') / lex::ascii::is_alnum);
+    }
+};
+
+struct kw_do : FOONATHAN_LEX_KEYWORD("do")
+{};
+struct kw_double : FOONATHAN_LEX_KEYWORD("double")
+{};
+struct kw_if : FOONATHAN_LEX_KEYWORD("if")
+{};
+struct kw_int : FOONATHAN_LEX_KEYWORD("int")
+{};
+struct kw_x_y : FOONATHAN_LEX_KEYWORD("x_y")
+{};
+// can never be an identifier
+struct kw_dash : FOONATHAN_LEX_KEYWORD("i-")
+{};
+
+using scan = lex::detail::keyword_scan<test_spec, identifier, kw_do, kw_double, kw_if, kw_int,
+                                       kw_x_y, kw_dash>;
+
+lex::match_result<test_spec> match(const char* str)
+{
+    return scan::try_match(str, str + std::strlen(str));
+}
+
+constexpr auto test_match()
+{
+    constexpr const char str[] = "double;";
+    return scan::try_match(str, str + sizeof(str) - 1);
+}
+
+// identifiers that are not of the shape `head + star(tail)`
+using other_spec = lex::token_spec<struct string_identifier, struct custom_identifier>;
+
+struct string_identifier : lex::identifier_token<string_identifier, other_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        namespace tr = lex::token_rule;
+        return tr::r("id") + tr::star(lex::ascii::is_alpha);
+    }
+};
+
+struct custom_identifier : lex::identifier_token<custom_identifier, other_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        namespace tr = lex::token_rule;
+        return lex::ascii::is_alpha + tr::star(lex::ascii::is_alpha);
+    }
+
+    static constexpr match_result try_match(const char*, const char*) noexcept
+    {
+        return unmatched();
+    }
+};
+} // namespace
+
+TEST_CASE("detail::keyword_scan")
+{
+    static_assert(lex::detail::has_identifier_shape<test_spec, identifier>::value, "");
+    static_assert(!lex::detail::has_identifier_shape<other_spec, string_identifier>::value, "");
+    static_assert(!lex::detail::has_identifier_shape<other_spec, custom_identifier>::value, "");
+
+    SUBCASE("keywords")
+    {
+        REQUIRE(match("do").kind.is(kw_do{}));
+        REQUIRE(match("double").kind.is(kw_double{}));
+        REQUIRE(match("if").kind.is(kw_if{}));
+        REQUIRE(match("int").kind.is(kw_int{}));
+        REQUIRE(match("x_y").kind.is(kw_x_y{}));
+        REQUIRE(match("double").bump == 6u);
+
+        constexpr auto result = test_match();
+        REQUIRE(result.kind.is(kw_double{}));
+        REQUIRE(result.bump == 6u);
+    }
+    SUBCASE("keyword followed by other character")
+    {
+        auto result = match("do+");
+        REQUIRE(result.kind.is(kw_do{}));
+        REQUIRE(result.bump == 2u);
+
+        result = match("int x");
+        REQUIRE(result.kind.is(kw_int{}));
+        REQUIRE(result.bump == 3u);
+    }
+    SUBCASE("identifiers")
+    {
+        // prefix of a keyword
+        auto result = match("doub");
+        REQUIRE(result.kind.is(identifier{}));
+        REQUIRE(result.bump == 4u);
+
+        // keyword is a prefix
+        result = match("doubles");
+        REQUIRE(result.kind.is(identifier{}));
+        REQUIRE(result.bump == 7u);
+
+        result = match("int_or_double");
+        REQUIRE(result.kind.is(identifier{}));
+        REQUIRE(result.bump == 13u);
+
+        // leaves the trie immediately
+        result = match("_abc123+");
+        REQUIRE(result.kind.is(identifier{}));
+        REQUIRE(result.bump == 7u);
+
+        // keyword characters that aren't part of the identifier
+        result = match("i-");
+        REQUIRE(result.kind.is(identifier{}));
+        REQUIRE(result.bump == 1u);
+    }
+    SUBCASE("no identifier")
+    {
+        REQUIRE(match("").is_unmatched());
+        REQUIRE(match("1do").is_unmatched());
+        REQUIRE(match("-").is_unmatched());
+    }
+    SUBCASE("end of input")
+    {
+        const char str[] = "double";
+        auto       result = scan::try_match(str, str + 2);
+        REQUIRE(result.kind.is(kw_do{}));
+        REQUIRE(result.bump == 2u);
+
+        result = scan::try_match(str, str + 4);
+        REQUIRE(result.kind.is(identifier{}));
+        REQUIRE(result.bump == 4u);
+    }
+    SUBCASE("no keywords")
+    {
+        using empty_scan = lex::detail::keyword_scan<test_spec, identifier>;
+
+        const char str[] = "double x";
+        auto       result = empty_scan::try_match(str, str + sizeof(str) - 1);
+        REQUIRE(result.kind.is(identifier{}));
+        REQUIRE(result.bump == 6u);
+    }
+}
@@ -84,6 +84,62 @@ constexpr auto test_lookup(Trie)
     auto str = "a";
     return Trie::try_match(str, str + 1).kind;
 }
+
+// enough single character tokens to use a jump table in the root
+using wide_tokens = token_spec<struct w0, struct w1, struct w2, struct w3, struct w4, struct w5,
+                               struct w6, struct w7, struct w8, struct w9>;
+template <char C>
+struct wide_token
+{
+    static constexpr auto character = C;
+};
+struct w0 : wide_token<'0'>
+{};
+struct w1 : wide_token<'1'>
+{};
+struct w2 : wide_token<'2'>
+{};
+struct w3 : wide_token<'3'>
+{};
+struct w4 : wide_token<'4'>
+{};
+struct w5 : wide_token<'5'>
+{};
+struct w6 : wide_token<'6'>
+{};
+struct w7 : wide_token<'7'>
+{};
+struct w8 : wide_token<'8'>
+{};
+struct w9 : wide_token<'9'>
+{};
+
+template <class Trie, class... Tokens>
+struct insert_wide_impl;
+template <class Trie>
+struct insert_wide_impl<Trie>
+{
+    using type = Trie;
+};
+template <class Trie, class Head, class... Tail>
+struct insert_wide_impl<Trie, Head, Tail...>
+{
+    using inserted = detail::trie<wide_tokens>::insert_literal<
+        Trie, token_kind<wide_tokens>(Head{}).get(), string<Head::character>>;
+    using type = typename insert_wide_impl<inserted, Tail...>::type;
+};
+
+using wide_trie0 = detail::trie<wide_tokens>::empty;
+using wide_trie1 = typename insert_wide_impl<wide_trie0, w0, w1, w2, w3, w4, w5, w6, w7>::type;
+using wide_trie2 = detail::trie<wide_tokens>::insert_literal<
+    wide_trie1, token_kind<wide_tokens>(w8{}).get(), string<'8', '9'>>;
+
+template <class Trie>
+constexpr auto test_wide_lookup(Trie)
+{
+    auto str = "7";
+    return Trie::try_match(str, str + 1).kind;
+}
 } // namespace
 
 TEST_CASE("detail::trie")
@@ -113,3 +169,77 @@ TEST_CASE("detail::trie")
     constexpr auto result = test_lookup(trie2{});
     REQUIRE(result.is<a>());
 }
+
+TEST_CASE("detail::trie jump table")
+{
+    static_assert(detail::mp::mp_size<wide_trie2::children>::value
+                      >= FOONATHAN_LEX_TRIE_JUMP_TABLE_THRESHOLD,
+                  "test requires a jump table");
+
+    verify<w0>(wide_trie2{}, "0", "0");
+    verify<w3>(wide_trie2{}, "31", "3");
+    verify<w7>(wide_trie2{}, "7", "7");
+    verify<w8>(wide_trie2{}, "89", "89");
+    verify_error(wide_trie2{}, "9");
+    verify_error(wide_trie2{}, "\xFF");
+
+    constexpr auto result = test_wide_lookup(wide_trie2{});
+    REQUIRE(result.is<w7>());
+}
+
+namespace
+{
+template <class Trie>
+struct insert_chain_impl
+{
+    using first  = test_trie::insert_literal<Trie, id_of<a>(), string<'x', 'y', 'z'>>;
+    using second = test_trie::insert_literal<
+        first, id_of<b>(),
+        string<'x', 'y', 'z', 'u', 'v', 'w', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'>>;
+    using third = test_trie::insert_literal<second, id_of<c>(), string<'q'>>;
+    using type  = third;
+};
+
+using chain_trie            = typename insert_chain_impl<test_trie::empty>::type;
+using compressed_chain_trie = test_trie::compress<chain_trie>;
+
+template <class Trie>
+constexpr auto test_chain_lookup(Trie)
+{
+    auto str = "xyzuvwabcdefgh";
+    return Trie::try_match(str, str + 14).kind;
+}
+} // namespace
+
+TEST_CASE("detail::trie path compression")
+{
+    // 'x' is followed by 'z' directly
+    using x_node = detail::mp::mp_front<compressed_chain_trie::children>;
+    static_assert(detail::mp::mp_front<x_node::children>::character == 'z', "");
+
+    verify<a>(compressed_chain_trie{}, "xyz", "xyz");
+    verify<a>(compressed_chain_trie{}, "xyzu", "xyz");
+    verify<a>(compressed_chain_trie{}, "xyzuvwabcdefgX", "xyz");
+    verify<a>(compressed_chain_trie{}, "xyzuvwabcdefgX-------------", "xyz");
+    verify<b>(compressed_chain_trie{}, "xyzuvwabcdefgh", "xyzuvwabcdefgh");
+    verify<b>(compressed_chain_trie{}, "xyzuvwabcdefgh-------------", "xyzuvwabcdefgh");
+    verify<c>(compressed_chain_trie{}, "q", "q");
+    verify_error(compressed_chain_trie{}, "xq");
+    verify_error(compressed_chain_trie{}, "xyq-------------");
+
+    // every prefix, with and without characters following it, matches like the original trie
+    for (auto input : {"xyzuvwabcdefgh", "xyzuvwabcdefgh-------------"})
+        for (auto i = 0u; i <= std::strlen(input); ++i)
+        {
+            INFO(input, " ", i);
+            auto expected = chain_trie::try_match(input, input + i);
+            auto actual   = compressed_chain_trie::try_match(input, input + i);
+            REQUIRE(actual.kind == expected.kind);
+            REQUIRE(actual.bump == expected.bump);
+            REQUIRE(actual.is_eof() == expected.is_eof());
+            REQUIRE(actual.is_unmatched() == expected.is_unmatched());
+        }
+
+    constexpr auto result = test_chain_lookup(compressed_chain_trie{});
+    REQUIRE(result.is<b>());
+}
@@ -0,0 +1,270 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/detail/trie_table.hpp>
+
+#include <doctest.h>
+#include <cstring>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using tokens = lex::token_spec<struct a, struct b, struct c, struct ab, struct abcd, struct bc>;
+struct a : FOONATHAN_LEX_LITERAL("a")
+{};
+struct b : FOONATHAN_LEX_LITERAL("b")
+{};
+struct c : FOONATHAN_LEX_LITERAL("c")
+{};
+struct ab : FOONATHAN_LEX_LITERAL("ab")
+{};
+struct abcd : FOONATHAN_LEX_LITERAL("abcd")
+{};
+struct bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+template <class... Literals>
+using test_table = lex::detail::trie_table<tokens, lex::detail::mp::mp_list<Literals...>,
+                                           lex::detail::mp::mp_list<>>;
+
+template <typename T, class Table>
+void verify(Table, const char* str, const char* prefix)
+{
+    auto result = Table::try_match(str, str + std::strlen(str));
+    REQUIRE(result.is_success());
+    REQUIRE(result.bump == std::strlen(prefix));
+    REQUIRE(result.kind.template is<T>());
+}
+
+template <class Table>
+void verify_error(Table, const char* str)
+{
+    auto result = Table::try_match(str, str + std::strlen(str));
+    REQUIRE(result.is_error());
+}
+
+template <class Table>
+constexpr auto test_lookup(Table)
+{
+    auto str = "abcd";
+    return Table::try_match(str, str + 4).kind;
+}
+} // namespace
+
+TEST_CASE("detail::trie_table")
+{
+    using table0 = test_table<>;
+    verify_error(table0{}, "a");
+    REQUIRE(table0::try_match("", static_cast<const char*>("")).is_eof());
+
+    using table1 = test_table<a, b, c>;
+    verify<a>(table1{}, "a", "a");
+    verify<b>(table1{}, "b", "b");
+    verify<c>(table1{}, "c", "c");
+    verify<a>(table1{}, "ab", "a");
+    verify_error(table1{}, "d");
+
+    using table2 = test_table<a, b, c, ab, abcd, bc>;
+    verify<a>(table2{}, "a", "a");
+    verify<ab>(table2{}, "ab", "ab");
+    verify<abcd>(table2{}, "abcd", "abcd");
+    verify<ab>(table2{}, "abc", "ab");
+    verify<b>(table2{}, "b", "b");
+    verify<bc>(table2{}, "bc", "bc");
+    verify<bc>(table2{}, "bcd", "bc");
+    verify<c>(table2{}, "c", "c");
+    verify<c>(table2{}, "cd", "c");
+    verify_error(table2{}, "d");
+
+    constexpr auto result = test_lookup(table2{});
+    REQUIRE(result.is<abcd>());
+}
+
+namespace
+{
+// the same tokens for both backends
+template <bool Flat>
+struct comment;
+template <bool Flat>
+struct number;
+template <bool Flat>
+struct dots;
+template <bool Flat>
+struct identifier;
+template <bool Flat>
+struct whitespace;
+
+template <bool Flat>
+using spec_tokens
+    = lex::token_spec<struct plus, struct plus_plus, struct plus_eq, struct minus, struct arrow,
+                      struct arrow_deref, struct slash, struct dot, struct ellipsis, comment<Flat>,
+                      number<Flat>, dots<Flat>, identifier<Flat>, struct kw_if, struct kw_int,
+                      whitespace<Flat>>;
+
+template <bool Flat>
+struct test_spec : spec_tokens<Flat>
+{
+    static constexpr bool flat_trie = Flat;
+};
+
+struct plus : FOONATHAN_LEX_LITERAL("+")
+{};
+struct plus_plus : FOONATHAN_LEX_LITERAL("++")
+{};
+struct plus_eq : FOONATHAN_LEX_LITERAL("+=")
+{};
+struct minus : FOONATHAN_LEX_LITERAL("-")
+{};
+struct arrow : FOONATHAN_LEX_LITERAL("->")
+{};
+struct arrow_deref : FOONATHAN_LEX_LITERAL("->*")
+{};
+struct slash : FOONATHAN_LEX_LITERAL("/")
+{};
+struct dot : FOONATHAN_LEX_LITERAL(".")
+{};
+struct ellipsis : FOONATHAN_LEX_LITERAL("...")
+{};
+
+template <bool Flat>
+struct comment : lex::rule_token<comment<Flat>, test_spec<Flat>>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r("/*") + lex::token_rule::until("*/");
+    }
+
+    static constexpr bool is_conflicting_literal(lex::token_kind<test_spec<Flat>> kind) noexcept
+    {
+        return kind == slash{};
+    }
+};
+
+template <bool Flat>
+struct number : lex::rule_token<number<Flat>, test_spec<Flat>>
+{
+    static constexpr auto rule() noexcept
+    {
+        namespace tr = lex::token_rule;
+        return tr::plus(lex::ascii::is_digit) / (tr::r('.') + tr::plus(lex::ascii::is_digit));
+    }
+
+    static constexpr bool is_conflicting_literal(lex::token_kind<test_spec<Flat>> kind) noexcept
+    {
+        return kind == dot{};
+    }
+};
+
+// four or more dots are an error
+template <bool Flat>
+struct dots : lex::basic_rule_token<dots<Flat>, test_spec<Flat>>
+{
+    using base = lex::basic_rule_token<dots<Flat>, test_spec<Flat>>;
+
+    static constexpr auto try_match(const char* str, const char* end) noexcept
+    {
+        auto cur = str;
+        while (cur != end && *cur == '.')
+            ++cur;
+        if (cur - str >= 4)
+            return base::error(static_cast<std::size_t>(cur - str));
+        else
+            return base::unmatched();
+    }
+
+    static constexpr bool is_conflicting_literal(lex::token_kind<test_spec<Flat>> kind) noexcept
+    {
+        return kind == dot{} || kind == ellipsis{};
+    }
+};
+
+template <bool Flat>
+struct identifier : lex::identifier_token<identifier<Flat>, test_spec<Flat>>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_alpha);
+    }
+};
+
+struct kw_if : FOONATHAN_LEX_KEYWORD("if")
+{};
+struct kw_int : FOONATHAN_LEX_KEYWORD("int")
+{};
+
+template <bool Flat>
+struct whitespace : lex::rule_token<whitespace<Flat>, test_spec<Flat>>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+// kind, offset and length of all tokens
+template <bool Flat>
+std::string tokenize(const std::string& input)
+{
+    std::string result;
+
+    lex::tokenizer<test_spec<Flat>> tokenizer(input.data(), input.size());
+    while (!tokenizer.is_done())
+    {
+        auto token = tokenizer.get();
+        result += std::to_string(token.kind().get());
+        result += " " + std::to_string(token.offset(tokenizer));
+        result += " " + std::to_string(token.spelling().size()) + "\n";
+    }
+
+    return result;
+}
+} // namespace
+
+TEST_CASE("detail::trie_table in tokenizer")
+{
+    static_assert(!std::is_same<lex::detail::token_spec_trie<test_spec<false>>,
+                                lex::detail::token_spec_trie<test_spec<true>>>::value,
+                  "");
+
+    SUBCASE("examples")
+    {
+        for (auto input : {"a+++=b->*c->d-e", "x/y /* comment */ 1.5 .5 . ... .... .....",
+                           "if int i iff in integer", "@ # / - + ."})
+        {
+            INFO(input);
+            REQUIRE(tokenize<true>(input) == tokenize<false>(input));
+        }
+    }
+    SUBCASE("all combinations")
+    {
+        // every string of up to four of these characters, terminated by a space,
+        // as the template trie returns EOF for a partial literal at the end
+        const char characters[] = "+-=>*/.1i@ ";
+        const auto count        = sizeof(characters) - 1u;
+
+        std::string input;
+        for (auto n = 1u; n <= 4u; ++n)
+        {
+            auto combinations = 1u;
+            for (auto i = 0u; i != n; ++i)
+                combinations *= count;
+
+            for (auto i = 0u; i != combinations; ++i)
+            {
+                input.clear();
+                for (auto cur = i, j = 0u; j != n; ++j, cur /= count)
+                    input += characters[cur % count];
+                input += ' ';
+
+                INFO(input);
+                REQUIRE(tokenize<true>(input) == tokenize<false>(input));
+            }
+        }
+    }
+}
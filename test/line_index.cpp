@@ -0,0 +1,131 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/line_index.hpp>
+
+#include <doctest.h>
+#include <random>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct token_a, struct whitespace>;
+
+struct token_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+void verify(lex::line_index& index, std::size_t offset, std::size_t line, std::size_t column)
+{
+    INFO(offset);
+    auto result = index.location(offset);
+    REQUIRE(result.line == line);
+    REQUIRE(result.column == column);
+}
+
+// scans the input from the beginning
+lex::line_column naive_location(const std::string& input, std::size_t offset)
+{
+    lex::line_column result{1, 1};
+    for (auto i = 0u; i != offset; ++i)
+    {
+        auto is_break = input[i] == '\n'
+                        || (input[i] == '\r' && (i + 1 == input.size() || input[i + 1] != '\n'));
+        if (is_break)
+        {
+            ++result.line;
+            result.column = 1;
+        }
+        else
+            ++result.column;
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("line_index")
+{
+    SUBCASE("line breaks")
+    {
+        const char     input[] = "ab\ncd\r\nef\rg\n\nh";
+        lex::line_index index(input, input + sizeof(input) - 1);
+        verify(index, 0, 1, 1);
+        verify(index, 2, 1, 3);
+        verify(index, 3, 2, 1);
+        verify(index, 5, 2, 3);
+        verify(index, 6, 2, 4);
+        verify(index, 7, 3, 1);
+        verify(index, 10, 4, 1);
+        verify(index, 11, 4, 2);
+        verify(index, 12, 5, 1);
+        verify(index, 13, 6, 1);
+        verify(index, 14, 6, 2);
+        // going back works as well
+        verify(index, 1, 1, 2);
+    }
+    SUBCASE("code points")
+    {
+        const char input[] = "\xC3\xA4\xE2\x82\xAC" "b\n\xF0\x9F\x98\x80" "c";
+        lex::line_index index(input, input + sizeof(input) - 1,
+                              lex::line_index::column_unit::code_points);
+        verify(index, 2, 1, 2);
+        verify(index, 5, 1, 3);
+        verify(index, 6, 1, 4);
+        verify(index, 11, 2, 2);
+        verify(index, 12, 2, 3);
+    }
+    SUBCASE("tokens")
+    {
+        const char                input[] = "a a\n  a\n";
+        lex::tokenizer<test_spec> tokenizer(input);
+        lex::line_index           index(tokenizer);
+
+        auto first = tokenizer.get();
+        REQUIRE(index.location(first).line == 1);
+        REQUIRE(index.location(first).column == 1);
+
+        tokenizer.bump();
+        auto third = tokenizer.get();
+        REQUIRE(index.location(third).line == 2);
+        REQUIRE(index.location(third).column == 3);
+
+        REQUIRE(index.location(tokenizer.peek()).line == 3);
+    }
+    SUBCASE("random")
+    {
+        // long enough for many blocks, with line breaks at block boundaries and long lines
+        const std::string snippets[]
+            = {"a", "bcd", "\n", "\r\n", "\r", "\n\n", "\r\r\n", std::string(100, 'x')};
+
+        std::mt19937 engine(42u);
+        std::string  input;
+        while (input.size() < 4096u)
+            input += snippets[std::uniform_int_distribution<std::size_t>(0, 7)(engine)];
+
+        lex::line_index index(input.data(), input.data() + input.size());
+        for (auto i = 0; i != 500; ++i)
+        {
+            // random offsets, so the index is sometimes extended and sometimes not
+            auto offset = std::uniform_int_distribution<std::size_t>(0, input.size())(engine);
+            auto result = naive_location(input, offset);
+            verify(index, offset, result.line, result.column);
+        }
+        for (auto offset = input.size() - 200u; offset <= input.size(); ++offset)
+        {
+            auto result = naive_location(input, offset);
+            verify(index, offset, result.line, result.column);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/lookahead_tokenizer.hpp>
+
+#include <doctest.h>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec
+    = lex::token_spec<struct token_a, struct token_bc, struct number, struct whitespace>;
+
+struct token_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct token_bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+// counts how often a number was matched
+int number_count = 0;
+
+struct number : lex::basic_rule_token<number, test_spec>
+{
+    static match_result try_match(const char* str, const char* end) noexcept
+    {
+        auto cur = str;
+        while (cur != end && *cur >= '0' && *cur <= '9')
+            ++cur;
+        if (cur == str)
+            return unmatched();
+
+        ++number_count;
+        return success(static_cast<std::size_t>(cur - str));
+    }
+};
+
+struct whitespace : FOONATHAN_LEX_LITERAL(" "), lex::whitespace_token
+{};
+
+template <class Token, std::size_t Capacity>
+void verify(const lex::lookahead_tokenizer<test_spec, Capacity>& tokenizer, const char* ptr,
+            bool is_done)
+{
+    REQUIRE(tokenizer.current_ptr() == ptr);
+    REQUIRE(tokenizer.is_done() == is_done);
+
+    REQUIRE(tokenizer.peek().is(Token{}));
+    REQUIRE(tokenizer.peek().spelling().data() == tokenizer.current_ptr());
+}
+} // namespace
+
+TEST_CASE("lookahead_tokenizer")
+{
+    number_count = 0;
+
+    const char                                array[] = "a 1 bc! 22 a 333";
+    lex::lookahead_tokenizer<test_spec, 4u> tokenizer(array);
+    REQUIRE(tokenizer.begin_ptr() == array);
+    REQUIRE(tokenizer.end_ptr() == array + sizeof(array) - 1);
+    verify<token_a>(tokenizer, array, false);
+
+    // peek ahead
+    REQUIRE(tokenizer.peek<1>().is(number{}));
+    REQUIRE(tokenizer.peek<1>().spelling().data() == array + 2);
+    REQUIRE(tokenizer.peek(2).is(token_bc{}));
+    REQUIRE(tokenizer.peek<3>().is(lex::error_token{}));
+    verify<token_a>(tokenizer, array, false);
+
+    // advance and go back
+    REQUIRE(tokenizer.get().is(token_a{}));
+    verify<number>(tokenizer, array + 2, false);
+    tokenizer.bump();
+    tokenizer.bump();
+    verify<lex::error_token>(tokenizer, array + 6, false);
+    tokenizer.reset(array + 2);
+    verify<number>(tokenizer, array + 2, false);
+    REQUIRE(tokenizer.peek<3>().is(number{}));
+    REQUIRE(number_count == 2);
+
+    // go to the end
+    tokenizer.reset(array + 6);
+    REQUIRE(tokenizer.peek<3>().is(number{}));
+    REQUIRE(tokenizer.peek<3>().spelling().data() == array + 13);
+    for (auto i = 0; i != 3; ++i)
+        tokenizer.bump();
+    verify<number>(tokenizer, array + 13, false);
+    tokenizer.bump();
+    verify<lex::eof_token>(tokenizer, array + 16, true);
+    tokenizer.bump();
+    verify<lex::eof_token>(tokenizer, array + 16, true);
+    REQUIRE(tokenizer.peek<3>().is(lex::eof_token{}));
+
+    // every number was only matched once
+    REQUIRE(number_count == 3);
+
+    // the first tokens are no longer buffered
+    tokenizer.reset(array + 2);
+    verify<number>(tokenizer, array + 2, false);
+    REQUIRE(number_count == 4);
+
+    // resetting to whitespace skips it
+    tokenizer.reset(array + 1);
+    verify<number>(tokenizer, array + 2, false);
+}
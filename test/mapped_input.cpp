@@ -0,0 +1,120 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/mapped_input.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <doctest.h>
+#include <fstream>
+#include <string>
+
+#include <foonathan/lex/tokenizer.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+struct test_spec : lex::token_spec<struct token_a, struct token_bc, struct whitespace>
+{
+    static constexpr bool null_terminated = true;
+};
+
+struct token_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct token_bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+struct whitespace : FOONATHAN_LEX_LITERAL(" "), lex::whitespace_token
+{};
+
+const char path[] = "foonathan_lex_mapped_input.txt";
+
+void write_file(const std::string& contents)
+{
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+}
+
+void verify(const lex::mapped_input& input, const std::string& contents)
+{
+    REQUIRE(input);
+    REQUIRE(input.error() == 0);
+    REQUIRE(input.size() == contents.size());
+    REQUIRE(input.end() == input.begin() + input.size());
+    REQUIRE(std::string(input.begin(), input.end()) == contents);
+
+    // followed by a page of zeros
+    for (auto ptr = input.end(); ptr != input.end() + 4096; ++ptr)
+        REQUIRE(*ptr == '\0');
+}
+} // namespace
+
+TEST_CASE("mapped_input")
+{
+    SUBCASE("default")
+    {
+        lex::mapped_input input;
+        REQUIRE(!input);
+        REQUIRE(input.error() == 0);
+    }
+    SUBCASE("missing file")
+    {
+        lex::mapped_input input("foonathan_lex_mapped_input_missing.txt");
+        REQUIRE(!input);
+        REQUIRE(input.error() != 0);
+    }
+#if FOONATHAN_LEX_HAS_MMAP
+    SUBCASE("not a regular file")
+    {
+        lex::mapped_input directory(".");
+        REQUIRE(!directory);
+        REQUIRE(directory.error() == ENODEV);
+
+        lex::mapped_input device("/dev/null");
+        REQUIRE(!device);
+        REQUIRE(device.error() == ENODEV);
+    }
+#endif
+    SUBCASE("empty file")
+    {
+        write_file("");
+        lex::mapped_input input(path);
+        verify(input, "");
+    }
+    SUBCASE("tokenize")
+    {
+        write_file("abc  a bc");
+        lex::mapped_input input(path);
+        verify(input, "abc  a bc");
+
+        lex::tokenizer<test_spec> tokenizer(input.begin(), input.end());
+        REQUIRE(tokenizer.get().is(token_a{}));
+        REQUIRE(tokenizer.get().is(token_bc{}));
+        REQUIRE(tokenizer.get().is(token_a{}));
+        REQUIRE(tokenizer.get().is(token_bc{}));
+        REQUIRE(tokenizer.is_done());
+    }
+    SUBCASE("page sized")
+    {
+        std::string contents;
+        for (auto i = 0; i != 4 * 1024; ++i)
+            contents += "a bc";
+        write_file(contents);
+
+        lex::mapped_input input(path);
+        verify(input, contents);
+
+        lex::mapped_input moved(std::move(input));
+        REQUIRE(!input);
+        verify(moved, contents);
+
+        input = std::move(moved);
+        REQUIRE(!moved);
+        verify(input, contents);
+    }
+
+    std::remove(path);
+}
@@ -0,0 +1,142 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/modal_tokenizer.hpp>
+
+#include <doctest.h>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec
+    = lex::token_spec<struct number, struct plus, struct string_begin, struct close_brace,
+                      struct whitespace, struct string_text, struct interpolation_begin,
+                      struct string_end>;
+
+struct code_mode;
+struct string_mode;
+
+//=== code mode ===//
+struct number : lex::rule_token<number, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_digit);
+    }
+};
+
+struct plus : FOONATHAN_LEX_LITERAL("+")
+{};
+
+struct string_begin : FOONATHAN_LEX_LITERAL("\""), lex::push_mode<string_mode>
+{};
+
+struct close_brace : FOONATHAN_LEX_LITERAL("}"), lex::pop_mode
+{};
+
+struct whitespace : FOONATHAN_LEX_LITERAL(" "), lex::whitespace_token
+{};
+
+struct code_mode : lex::token_mode<number, plus, string_begin, close_brace, whitespace>
+{};
+
+//=== string mode ===//
+struct string_text : lex::basic_rule_token<string_text, test_spec>
+{
+    static constexpr match_result try_match(const char* str, const char* end) noexcept
+    {
+        auto cur = str;
+        while (cur != end && *cur != '"' && !(*cur == '$' && cur + 1 != end && cur[1] == '{'))
+            ++cur;
+
+        if (cur == str)
+            return unmatched();
+        else
+            return success(static_cast<std::size_t>(cur - str));
+    }
+};
+
+struct interpolation_begin : FOONATHAN_LEX_LITERAL("${"), lex::push_mode<code_mode>
+{};
+
+struct string_end : FOONATHAN_LEX_LITERAL("\""), lex::pop_mode
+{};
+
+struct string_mode : lex::token_mode<string_text, interpolation_begin, string_end>
+{};
+
+using tokenizer = lex::modal_tokenizer<test_spec, code_mode, string_mode>;
+
+template <class Token, class Mode>
+void verify(tokenizer& tokenizer, const char* ptr, std::size_t depth)
+{
+    REQUIRE(tokenizer.current_ptr() == ptr);
+    REQUIRE(tokenizer.peek().is(Token{}));
+    REQUIRE(tokenizer.is_mode<Mode>());
+    REQUIRE(tokenizer.mode_depth() == depth);
+    tokenizer.bump();
+}
+} // namespace
+
+TEST_CASE("modal_tokenizer")
+{
+    const char array[] = "1 + \"a b${2 + \"c\"}}\" } 3+";
+    tokenizer  tokenizer(array);
+    REQUIRE(tokenizer.begin_ptr() == array);
+    REQUIRE(tokenizer.end_ptr() == array + sizeof(array) - 1);
+
+    verify<number, code_mode>(tokenizer, array, 0);
+    verify<plus, code_mode>(tokenizer, array + 2, 0);
+    verify<string_begin, code_mode>(tokenizer, array + 4, 1);
+    // whitespace is part of the string text
+    verify<string_text, string_mode>(tokenizer, array + 5, 1);
+    verify<interpolation_begin, string_mode>(tokenizer, array + 8, 2);
+    verify<number, code_mode>(tokenizer, array + 10, 2);
+    verify<plus, code_mode>(tokenizer, array + 12, 2);
+    verify<string_begin, code_mode>(tokenizer, array + 14, 3);
+    verify<string_text, string_mode>(tokenizer, array + 15, 3);
+    verify<string_end, string_mode>(tokenizer, array + 16, 2);
+    verify<close_brace, code_mode>(tokenizer, array + 17, 1);
+    // a closing brace in string mode is just text
+    verify<string_text, string_mode>(tokenizer, array + 18, 1);
+    verify<string_end, string_mode>(tokenizer, array + 19, 0);
+    // popping the initial mode does nothing
+    verify<close_brace, code_mode>(tokenizer, array + 21, 0);
+    verify<number, code_mode>(tokenizer, array + 23, 0);
+    verify<plus, code_mode>(tokenizer, array + 24, 0);
+
+    REQUIRE(tokenizer.is_done());
+    verify<lex::eof_token, code_mode>(tokenizer, array + 25, 0);
+    verify<lex::eof_token, code_mode>(tokenizer, array + 25, 0);
+}
+
+TEST_CASE("modal_tokenizer nesting too deep")
+{
+    // every `${` pushes the code mode, every `"` the string mode
+    std::string input = "\"";
+    for (auto i = 0u; i != tokenizer::max_mode_depth; ++i)
+        input += "${\"";
+
+    ::tokenizer tokenizer(input.data(), input.size());
+    for (auto depth = 1u; depth != tokenizer::max_mode_depth; ++depth)
+    {
+        REQUIRE(tokenizer.mode_depth() == depth);
+        tokenizer.bump();
+    }
+
+    // the stack is full, so the next push is an error
+    REQUIRE(tokenizer.peek().is(lex::error_token{}));
+    REQUIRE(tokenizer.peek().spelling() == "${");
+    REQUIRE(tokenizer.is_mode<string_mode>());
+    REQUIRE(tokenizer.mode_depth() == tokenizer::max_mode_depth - 1u);
+    tokenizer.bump();
+
+    // still in string mode, so the quote ends the string
+    REQUIRE(tokenizer.peek().is(string_end{}));
+    REQUIRE(tokenizer.mode_depth() == tokenizer::max_mode_depth - 2u);
+}
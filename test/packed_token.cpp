@@ -0,0 +1,115 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/packed_token.hpp>
+
+#include <doctest.h>
+#include <string>
+
+#include "tokenize.hpp"
+
+namespace
+{
+using test_spec = lex::token_spec<struct token_a, struct token_bc, struct token_b_star>;
+
+struct token_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct token_bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+struct token_b_star : lex::rule_token<token_b_star, test_spec>
+{
+    static constexpr const char* name = "b*";
+
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::token_rule::r('b'));
+    }
+};
+
+struct trivia_spec : lex::token_spec<struct token_c, struct whitespace>
+{
+    static constexpr bool preserve_trivia = true;
+};
+
+struct token_c : FOONATHAN_LEX_LITERAL("c")
+{};
+
+struct whitespace : FOONATHAN_LEX_LITERAL(" "), lex::whitespace_token
+{};
+
+template <class Tokenizer>
+FOONATHAN_LEX_TEST_CONSTEXPR bool verify(const Tokenizer& tokenizer, lex::token<test_spec> token)
+{
+    auto packed   = lex::packed_token<test_spec>(tokenizer, token);
+    auto unpacked = packed.unpack(tokenizer);
+    return packed.kind() == token.kind() && packed.offset() == token.offset(tokenizer)
+           && packed.spelling(tokenizer) == token.spelling() && unpacked.kind() == token.kind()
+           && unpacked.spelling().data() == token.spelling().data()
+           && unpacked.spelling() == token.spelling();
+}
+} // namespace
+
+TEST_CASE("packed_token")
+{
+    static_assert(sizeof(lex::packed_token<test_spec>) == 8u, "");
+    static_assert(lex::packed_token<test_spec>::max_packed_length == 0xFFFFFEu, "");
+
+    static constexpr const char       array[]   = "abc!bbb";
+    constexpr auto                    tokenizer = lex::tokenizer<test_spec>(array);
+    FOONATHAN_LEX_TEST_CONSTEXPR auto result    = tokenize<test_spec>(tokenizer);
+
+    REQUIRE(result.size() == 4);
+    for (auto i = 0u; i != result.size(); ++i)
+    {
+        auto packed = lex::packed_token<test_spec>(tokenizer, result[i]);
+        REQUIRE(!packed.is_length_overflow());
+        REQUIRE(verify(tokenizer, result[i]));
+    }
+
+    auto packed = lex::packed_token<test_spec>(tokenizer, result[2]);
+    REQUIRE(!packed);
+    REQUIRE(packed.is(lex::error_token{}));
+    REQUIRE(packed.name() == std::string("<error>"));
+    REQUIRE(packed == lex::packed_token<test_spec>(array, result[2]));
+    REQUIRE(packed != lex::packed_token<test_spec>(tokenizer, result[3]));
+
+    SUBCASE("length overflow")
+    {
+        // one character longer than can be stored
+        auto long_input
+            = "a" + std::string(lex::packed_token<test_spec>::max_packed_length + 1u, 'b');
+        lex::tokenizer<test_spec> long_tokenizer(long_input.data(),
+                                                 long_input.data() + long_input.size());
+        long_tokenizer.bump();
+
+        auto token = long_tokenizer.peek();
+        REQUIRE(token.is(token_b_star{}));
+        REQUIRE(token.spelling().size() == long_input.size() - 1u);
+
+        auto packed_long = lex::packed_token<test_spec>(long_tokenizer, token);
+        REQUIRE(packed_long.is_length_overflow());
+        REQUIRE(packed_long.is(token_b_star{}));
+        REQUIRE(packed_long.offset() == 1u);
+        REQUIRE(verify(long_tokenizer, token));
+    }
+    SUBCASE("trivia")
+    {
+        static_assert(sizeof(lex::packed_token<trivia_spec>) == 12u, "");
+
+        const char                  input[] = "c  c";
+        lex::tokenizer<trivia_spec> trivia_tokenizer(input);
+
+        auto first  = lex::packed_token<trivia_spec>(trivia_tokenizer, trivia_tokenizer.get());
+        auto second = lex::packed_token<trivia_spec>(trivia_tokenizer, trivia_tokenizer.get());
+        REQUIRE(first != second);
+
+        auto token = second.unpack(trivia_tokenizer);
+        REQUIRE(token.spelling().data() == input + 3);
+        REQUIRE(token.leading_trivia().data() == input + 1);
+        REQUIRE(token.leading_trivia() == "  ");
+        REQUIRE(first.unpack(trivia_tokenizer).leading_trivia().size() == 0u);
+    }
+}
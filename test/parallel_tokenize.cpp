@@ -0,0 +1,121 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/parallel_tokenize.hpp>
+
+#include <doctest.h>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct comment, struct string, struct slash, struct number,
+                                  struct whitespace>;
+
+struct slash : FOONATHAN_LEX_LITERAL("/")
+{};
+
+// comments and strings can contain newlines, so a chunk can start inside one
+struct comment : lex::rule_token<comment, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r("/*") + lex::token_rule::until("*/");
+    }
+
+    static constexpr bool is_conflicting_literal(lex::token_kind<test_spec> kind) noexcept
+    {
+        return kind == slash{};
+    }
+};
+
+struct string : lex::rule_token<string, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r('"') + lex::token_rule::until('"');
+    }
+};
+
+struct number : lex::rule_token<number, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_digit);
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+void verify(const std::string& input, unsigned thread_count)
+{
+    lex::token_buffer<test_spec> expected;
+    lex::tokenize_all(input.data(), input.data() + input.size(), expected);
+
+    lex::token_buffer<test_spec> buffer;
+    lex::tokenize_all(input.data(), input.data() + input.size(), buffer, thread_count);
+    REQUIRE(buffer.begin_ptr() == input.data());
+    REQUIRE(buffer.size() == expected.size());
+    for (auto i = 0u; i != buffer.size(); ++i)
+    {
+        REQUIRE(buffer.kind(i) == expected.kind(i));
+        REQUIRE(buffer.offset(i) == expected.offset(i));
+        REQUIRE(buffer.length(i) == expected.length(i));
+    }
+}
+} // namespace
+
+TEST_CASE("parallel tokenize_all")
+{
+    std::string input;
+    SUBCASE("small")
+    {
+        input = "12 / \"a\nb\" /* 3\n4 */ 5!";
+    }
+    SUBCASE("lines")
+    {
+        for (auto i = 0; input.size() < 1024 * 1024u; ++i)
+            input += std::to_string(i) + " / " + std::to_string(i * i) + "\n";
+    }
+    SUBCASE("long tokens")
+    {
+        // comments and strings spanning many lines, with unrelated tokens inside
+        for (auto i = 0; input.size() < 1024 * 1024u; ++i)
+        {
+            input += "1 /* ";
+            for (auto j = 0; j != i % 4000; ++j)
+                input += j % 10 == 0 ? "\n" : "2 / \"";
+            input += " */ 3\n\"";
+            for (auto j = 0; j != i % 3000; ++j)
+                input += j % 7 == 0 ? "\n/*" : " 4 ";
+            input += "\"\n";
+        }
+    }
+    SUBCASE("no newlines")
+    {
+        for (auto i = 0; input.size() < 1024 * 1024u; ++i)
+            input += std::to_string(i) + " /* " + std::to_string(i) + " */ ";
+    }
+    SUBCASE("unterminated comment")
+    {
+        input = "1 /*";
+        for (auto i = 0; input.size() < 1024 * 1024u; ++i)
+            input += "\n2 3";
+    }
+
+    for (auto thread_count : {0u, 1u, 2u, 3u, 8u})
+    {
+        INFO(thread_count);
+        verify(input, thread_count);
+    }
+}
@@ -0,0 +1,165 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/retokenize.hpp>
+
+#include <doctest.h>
+#include <random>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct ellipsis, struct dot, struct comment, struct slash,
+                                  struct number, struct whitespace>;
+
+struct ellipsis : FOONATHAN_LEX_LITERAL("...")
+{};
+
+struct dot : FOONATHAN_LEX_LITERAL(".")
+{};
+
+struct slash : FOONATHAN_LEX_LITERAL("/")
+{};
+
+struct comment : lex::rule_token<comment, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r("/*") + lex::token_rule::until("*/");
+    }
+
+    static constexpr bool is_conflicting_literal(lex::token_kind<test_spec> kind) noexcept
+    {
+        return kind == slash{};
+    }
+};
+
+struct number : lex::rule_token<number, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_digit);
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+lex::token_buffer<test_spec> tokenize(const std::string& input)
+{
+    lex::token_buffer<test_spec> result;
+    lex::tokenize_all(input.data(), input.data() + input.size(), result);
+    return result;
+}
+
+void verify(const lex::token_buffer<test_spec>& tokens, const std::string& input)
+{
+    auto expected = tokenize(input);
+    REQUIRE(tokens.begin_ptr() == input.data());
+    REQUIRE(tokens.size() == expected.size());
+    for (auto i = 0u; i != tokens.size(); ++i)
+    {
+        REQUIRE(tokens.kind(i) == expected.kind(i));
+        REQUIRE(tokens.offset(i) == expected.offset(i));
+        REQUIRE(tokens.length(i) == expected.length(i));
+    }
+}
+
+lex::token_splice edit(lex::token_buffer<test_spec>& tokens, std::string& input,
+                       std::size_t offset, std::size_t length, const std::string& text,
+                       std::size_t lookbehind = 1)
+{
+    input.replace(offset, length, text);
+
+    lex::token_buffer<test_spec> new_tokens;
+    auto splice = lex::retokenize(tokens, input.data(), input.data() + input.size(),
+                                  lex::text_edit{offset, length, text.size()}, new_tokens,
+                                  lookbehind);
+    lex::apply_splice(tokens, splice, new_tokens);
+    verify(tokens, input);
+    return splice;
+}
+} // namespace
+
+TEST_CASE("retokenize")
+{
+    std::string input  = "1 / 2 .. 3 /* 4 */ 5 . 6";
+    auto        tokens = tokenize(input);
+    REQUIRE(tokens.size() == 10);
+
+    SUBCASE("insert")
+    {
+        auto splice = edit(tokens, input, 2, 0, "23");
+        REQUIRE(input == "1 23/ 2 .. 3 /* 4 */ 5 . 6");
+        REQUIRE(splice.first == 0);
+        REQUIRE(splice.old_count == 1);
+        REQUIRE(splice.new_count == 2);
+        REQUIRE(splice.shift == 2);
+    }
+    SUBCASE("remove")
+    {
+        auto splice = edit(tokens, input, 11, 8, "");
+        REQUIRE(input == "1 / 2 .. 3 5 . 6");
+        REQUIRE(splice.first == 4);
+        REQUIRE(splice.old_count == 3);
+        REQUIRE(splice.new_count == 2);
+        REQUIRE(splice.shift == -8);
+    }
+    SUBCASE("merge with previous token")
+    {
+        // turns ".." into "..." which requires re-tokenizing the token before it as well
+        edit(tokens, input, 8, 0, ".");
+        REQUIRE(input == "1 / 2 ... 3 /* 4 */ 5 . 6");
+    }
+    SUBCASE("start comment")
+    {
+        edit(tokens, input, 3, 0, "*");
+        REQUIRE(input == "1 /* 2 .. 3 /* 4 */ 5 . 6");
+        edit(tokens, input, 3, 1, "");
+        REQUIRE(input == "1 / 2 .. 3 /* 4 */ 5 . 6");
+    }
+    SUBCASE("close comment")
+    {
+        edit(tokens, input, 16, 2, "");
+        REQUIRE(input == "1 / 2 .. 3 /* 4  5 . 6");
+
+        // the unterminated comment was tokenized as slash and star,
+        // and the slash is two tokens before the edit
+        edit(tokens, input, 16, 0, "*/", 2);
+        REQUIRE(input == "1 / 2 .. 3 /* 4 */ 5 . 6");
+    }
+    SUBCASE("at the ends")
+    {
+        edit(tokens, input, 0, 0, " 0");
+        edit(tokens, input, input.size(), 0, "7");
+        edit(tokens, input, input.size() - 3, 3, "");
+        edit(tokens, input, 0, input.size(), "");
+        REQUIRE(tokens.empty());
+    }
+    SUBCASE("random")
+    {
+        // no comments, as the tokens before an unterminated comment depend on the entire input
+        const char* snippets[] = {"1", "23", " ", "\n", ".", "..", "/", "!"};
+
+        std::mt19937 engine(42u);
+        for (auto i = 0; i != 500; ++i)
+        {
+            auto offset = std::uniform_int_distribution<std::size_t>(0, input.size())(engine);
+            auto length
+                = std::uniform_int_distribution<std::size_t>(0, (input.size() - offset) / 4)(
+                    engine);
+            auto text = snippets[std::uniform_int_distribution<std::size_t>(0, 7)(engine)];
+            edit(tokens, input, offset, length, text);
+        }
+    }
+}
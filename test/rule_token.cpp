@@ -2,10 +2,12 @@
 // This file is subject to the license terms in the LICENSE file
 // found in the top-level directory of this distribution.
 
+#include <foonathan/lex/ascii.hpp>
 #include <foonathan/lex/rule_token.hpp>
 
 #include "tokenize.hpp"
 #include <doctest.h>
+#include <string>
 
 namespace
 {
@@ -327,6 +329,47 @@ TEST_CASE("rule_token")
             REQUIRE(verify<PEG>("b", 0));
             REQUIRE(verify<PEG>("", 0));
         }
+        SUBCASE("star space")
+        {
+            FOONATHAN_LEX_PEG(star(lex::ascii::is_space));
+
+            // still works at compile-time
+            static_assert(match<PEG>("                                        \t\nx").bump == 42,
+                          "");
+
+            // long runs are skipped in blocks, the rest one by one
+            for (auto length = 0u; length != 100u; ++length)
+                for (auto terminator : {'a', '\0', '\x08', '\x0E', '\x80', '\xFF'})
+                {
+                    std::string input;
+                    for (auto i = 0u; i != length; ++i)
+                        input += " \t\n\v\f\r"[i % 6];
+                    input += terminator;
+                    input += "                                ";
+
+                    auto cur = input.c_str();
+                    PEG::rule().try_match(cur, input.c_str() + input.size());
+                    REQUIRE(cur == input.c_str() + length);
+                }
+        }
+        SUBCASE("star blank")
+        {
+            FOONATHAN_LEX_PEG(star(lex::ascii::is_blank));
+
+            for (auto length = 0u; length != 100u; ++length)
+                for (auto terminator : {'a', '\n', '\r', '\v'})
+                {
+                    std::string input;
+                    for (auto i = 0u; i != length; ++i)
+                        input += i % 3 == 0 ? '\t' : ' ';
+                    input += terminator;
+                    input += "                                ";
+
+                    auto cur = input.c_str();
+                    PEG::rule().try_match(cur, input.c_str() + input.size());
+                    REQUIRE(cur == input.c_str() + length);
+                }
+        }
         SUBCASE("lookahead")
         {
             FOONATHAN_LEX_PEG(lookahead("ab") + 'a');
@@ -462,4 +505,22 @@ TEST_CASE("rule_token")
             REQUIRE(verify<PEG>("aaaa", 4));
         }
     }
+    SUBCASE("can_start")
+    {
+        namespace tr = lex::token_rule;
+
+        constexpr auto seq = tr::opt('L') + '"' + tr::until('"');
+        static_assert(tr::detail::can_start(seq, 'L'), "");
+        static_assert(tr::detail::can_start(seq, '"'), "");
+        static_assert(!tr::detail::can_start(seq, 'a'), "");
+        static_assert(!tr::detail::is_nullable(seq), "");
+
+        constexpr auto pred = !tr::r('0') + tr::plus(lex::ascii::is_digit);
+        static_assert(tr::detail::can_start(pred, '1'), "");
+        static_assert(!tr::detail::can_start(pred, 'a'), "");
+
+        constexpr auto any = tr::star('a') + tr::any;
+        static_assert(tr::detail::can_start(any, 'b'), "");
+        static_assert(tr::detail::is_nullable(tr::star('a')), "");
+    }
 }
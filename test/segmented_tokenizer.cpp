@@ -0,0 +1,188 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/segmented_tokenizer.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+#include <foonathan/lex/ascii.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct comment, struct slash, struct arrow, struct minus,
+                                  struct identifier, struct whitespace>;
+
+struct slash : FOONATHAN_LEX_LITERAL("/")
+{};
+
+struct arrow : FOONATHAN_LEX_LITERAL("->")
+{};
+
+struct minus : FOONATHAN_LEX_LITERAL("-")
+{};
+
+struct comment : lex::rule_token<comment, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r("/*") + lex::token_rule::until("*/");
+    }
+
+    static constexpr bool is_conflicting_literal(lex::token_kind<test_spec> kind) noexcept
+    {
+        return kind == slash{};
+    }
+};
+
+struct identifier : lex::rule_token<identifier, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_alpha);
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+struct result
+{
+    lex::token_kind<test_spec> kind;
+    std::string                spelling;
+    std::size_t                offset;
+};
+
+std::vector<result> tokenize(lex::segmented_tokenizer<test_spec> tokenizer)
+{
+    std::vector<result> tokens;
+    while (!tokenizer.is_done())
+    {
+        auto offset   = tokenizer.current_offset();
+        auto token    = tokenizer.get();
+        auto spelling = std::string(token.spelling().begin(), token.spelling().end());
+        tokens.push_back({token.kind(), spelling, offset});
+    }
+    return tokens;
+}
+
+// splits the input at the given positions
+void verify(const std::string& input, std::vector<std::size_t> splits, std::size_t lookahead)
+{
+    std::vector<lex::token_spelling> segments;
+    auto                             last = std::size_t(0);
+    splits.push_back(input.size());
+    for (auto split : splits)
+    {
+        segments.emplace_back(input.data() + last, split - last);
+        last = split;
+    }
+
+    std::vector<result> expected;
+    lex::tokenizer<test_spec> tokenizer(input.data(), input.size());
+    while (!tokenizer.is_done())
+    {
+        auto token = tokenizer.get();
+        expected.push_back({token.kind(),
+                            std::string(token.spelling().begin(), token.spelling().end()),
+                            token.offset(tokenizer)});
+    }
+
+    auto actual = tokenize(lex::segmented_tokenizer<test_spec>(segments.data(), segments.size(),
+                                                               lookahead));
+    REQUIRE(actual.size() == expected.size());
+    for (auto i = 0u; i != actual.size(); ++i)
+    {
+        REQUIRE(actual[i].kind == expected[i].kind);
+        REQUIRE(actual[i].spelling == expected[i].spelling);
+        REQUIRE(actual[i].offset == expected[i].offset);
+    }
+}
+} // namespace
+
+TEST_CASE("segmented_tokenizer")
+{
+    SUBCASE("empty")
+    {
+        REQUIRE(tokenize(lex::segmented_tokenizer<test_spec>(nullptr, 0)).empty());
+        verify("", {0, 0}, 4);
+    }
+    SUBCASE("no boundaries")
+    {
+        verify("abc -> - /* x */ / !", {}, 4);
+    }
+    SUBCASE("tokens crossing boundaries")
+    {
+        const std::string input = "abc -> - / ! def";
+        for (auto split = std::size_t(0); split <= input.size(); ++split)
+        {
+            INFO(split);
+            verify(input, {split}, 0);
+            verify(input, {split}, 4);
+        }
+        verify(input, {1, 2, 2, 3, 5, 10, 11}, 0);
+    }
+    SUBCASE("lookahead")
+    {
+        // the comment rule looks up to seven characters past the beginning of a slash
+        const std::string input = "a / b /* x */ / c";
+        for (auto split = std::size_t(0); split <= input.size(); ++split)
+        {
+            INFO(split);
+            verify(input, {split}, 7);
+        }
+        verify(input, {1, 2, 7, 8, 9, 11}, 7);
+    }
+    SUBCASE("long tokens")
+    {
+        std::string identifier(1000, 'x');
+        std::string comment = "/*" + identifier + "*/";
+
+        std::vector<std::size_t> splits;
+        for (auto i = std::size_t(7); i < 1000; i += 13)
+            splits.push_back(i);
+        verify("a " + identifier + " b", splits, 0);
+        verify("a " + comment + " b", splits, comment.size());
+    }
+    SUBCASE("long tokens with a small lookahead")
+    {
+        std::string comment = "/*" + std::string(200, 'x') + "*/";
+        std::string input   = "a " + comment + " / " + comment;
+        for (auto split = std::size_t(0); split <= input.size(); split += 7)
+        {
+            INFO(split);
+            verify(input, {split}, 0);
+            verify(input, {split}, 4);
+        }
+        verify(input, {100, 110, 300, 301, 302}, 4);
+    }
+    SUBCASE("tokens only point into the buffer if they cross a boundary")
+    {
+        const char                        input[]    = "ab ->-";
+        lex::token_spelling               segments[] = {lex::token_spelling(input, 2),
+                                          lex::token_spelling(input + 2, 3),
+                                          lex::token_spelling(input + 5, 1)};
+        lex::segmented_tokenizer<test_spec> tokenizer(segments, 3);
+
+        REQUIRE(tokenizer.peek().spelling().data() == input);
+        REQUIRE(tokenizer.current_segment() == 0u);
+        tokenizer.bump();
+        REQUIRE(tokenizer.peek().is(arrow{}));
+        REQUIRE(tokenizer.peek().spelling().data() == input + 3);
+        REQUIRE(tokenizer.current_segment() == 1u);
+
+        auto token = tokenizer.get();
+        REQUIRE(token.is(arrow{}));
+        REQUIRE(tokenizer.peek().is(minus{}));
+        REQUIRE(tokenizer.current_offset() == 5u);
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/stacked_tokenizer.hpp>
+
+#include <doctest.h>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct token_a, struct token_bc, struct whitespace>;
+
+struct token_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct token_bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+struct whitespace : FOONATHAN_LEX_LITERAL(" "), lex::whitespace_token
+{};
+
+template <class Token>
+void verify(lex::stacked_tokenizer<test_spec>& tokenizer, const char* ptr, std::size_t buffer,
+            std::size_t depth)
+{
+    REQUIRE(!tokenizer.is_done());
+    REQUIRE(tokenizer.depth() == depth);
+    REQUIRE(tokenizer.buffer() == buffer);
+
+    auto token = tokenizer.get();
+    REQUIRE(token.is(Token{}));
+    REQUIRE(token.spelling().data() == ptr);
+    REQUIRE(token.buffer() == buffer);
+}
+} // namespace
+
+TEST_CASE("stacked_tokenizer")
+{
+    const char outer[]  = "a bc a";
+    const char middle[] = " bc a ";
+    const char inner[]  = "bc";
+    const char empty[]  = " ";
+
+    lex::stacked_tokenizer<test_spec> tokenizer(outer);
+    verify<token_a>(tokenizer, outer, 0, 0);
+
+    // the current token of the outer buffer is delayed until the inner one is done
+    REQUIRE(tokenizer.push(middle, sizeof(middle) - 1) == 1u);
+    verify<token_bc>(tokenizer, middle + 1, 1, 1);
+
+    REQUIRE(tokenizer.push(inner, sizeof(inner) - 1) == 2u);
+    REQUIRE(tokenizer.peek().offset(tokenizer) == 0u);
+    verify<token_bc>(tokenizer, inner, 2, 2);
+
+    verify<token_a>(tokenizer, middle + 4, 1, 1);
+    verify<token_bc>(tokenizer, outer + 2, 0, 0);
+
+    // a buffer without tokens is popped immediately
+    REQUIRE(tokenizer.push(empty, sizeof(empty) - 1) == 3u);
+    REQUIRE(tokenizer.depth() == 0u);
+    REQUIRE(tokenizer.peek().offset(tokenizer) == 5u);
+    verify<token_a>(tokenizer, outer + 5, 0, 0);
+    REQUIRE(tokenizer.is_done());
+
+    // pushing at the end of the input
+    tokenizer.push(inner, sizeof(inner) - 1);
+    verify<token_bc>(tokenizer, inner, 4, 1);
+    REQUIRE(tokenizer.is_done());
+    REQUIRE(tokenizer.get().is(lex::eof_token{}));
+    REQUIRE(tokenizer.current_ptr() == outer + 6);
+
+    REQUIRE(tokenizer.buffer_begin(0) == outer);
+    REQUIRE(tokenizer.buffer_begin(4) == inner);
+}
@@ -0,0 +1,147 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/streaming_tokenizer.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+#include <foonathan/lex/ascii.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct ellipsis, struct dot, struct arrow, struct minus,
+                                  struct number, struct string, struct whitespace>;
+
+struct ellipsis : FOONATHAN_LEX_LITERAL("...")
+{};
+
+struct dot : FOONATHAN_LEX_LITERAL(".")
+{};
+
+struct arrow : FOONATHAN_LEX_LITERAL("->")
+{};
+
+struct minus : FOONATHAN_LEX_LITERAL("-")
+{};
+
+struct number : lex::rule_token<number, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_digit);
+    }
+};
+
+struct string : lex::rule_token<string, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r('"') + lex::token_rule::until('"');
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+struct token_info
+{
+    std::size_t   kind;
+    std::string   spelling;
+    std::uint64_t offset;
+
+    bool operator==(const token_info& other) const
+    {
+        return kind == other.kind && spelling == other.spelling && offset == other.offset;
+    }
+};
+
+std::vector<token_info> tokenize_whole(const std::string& input)
+{
+    std::vector<token_info> result;
+
+    lex::tokenizer<test_spec> tokenizer(input.data(), input.size());
+    while (!tokenizer.is_done())
+    {
+        auto token = tokenizer.get();
+        result.push_back({token.kind().get(), std::string(token.spelling().data(),
+                                                          token.spelling().size()),
+                          token.offset(tokenizer)});
+    }
+
+    return result;
+}
+
+std::vector<token_info> tokenize_streaming(const std::string& input, std::size_t chunk_size,
+                                           std::size_t lookahead)
+{
+    std::vector<token_info> result;
+
+    auto                                 pos = std::size_t(0);
+    lex::streaming_tokenizer<test_spec> tokenizer(
+        [&](char* buffer, std::size_t size) {
+            auto count = std::min(size, input.size() - pos);
+            input.copy(buffer, count, pos);
+            pos += count;
+            return count;
+        },
+        chunk_size, lookahead);
+    while (!tokenizer.is_done())
+    {
+        auto offset = tokenizer.current_offset();
+        auto token  = tokenizer.get();
+        // the token is still valid after get()
+        REQUIRE(tokenizer.offset(token) == offset);
+        result.push_back({token.kind().get(), std::string(token.spelling().data(),
+                                                          token.spelling().size()),
+                          offset});
+
+        // memory is bounded by the chunk size and the tokens
+        REQUIRE(tokenizer.buffer_capacity() <= 2 * chunk_size + lookahead + 256);
+    }
+
+    return result;
+}
+} // namespace
+
+TEST_CASE("streaming_tokenizer")
+{
+    std::string input;
+    for (auto i = 0; i != 20; ++i)
+        input += "... -> 123 .-. \n" + std::string(static_cast<std::size_t>(i), ' ') + "..-.!>";
+    input += "12345678901234567890";
+
+    auto expected = tokenize_whole(input);
+    for (auto chunk_size : {1u, 2u, 3u, 7u, 16u, 1024u})
+    {
+        INFO(chunk_size);
+        REQUIRE(tokenize_streaming(input, chunk_size, 3u) == expected);
+        REQUIRE(tokenize_streaming(input, chunk_size, 64u) == expected);
+    }
+
+    SUBCASE("empty")
+    {
+        REQUIRE(tokenize_streaming("", 4u, 3u).empty());
+        REQUIRE(tokenize_streaming("   ", 4u, 3u).empty());
+    }
+    SUBCASE("literal prefix at the end")
+    {
+        REQUIRE(tokenize_streaming("-..", 2u, 3u) == tokenize_whole("-.."));
+    }
+    SUBCASE("token longer than the lookahead")
+    {
+        auto long_input
+            = "-> \"" + std::string(200u, 'a') + "\" 123 \"" + std::string(150u, 'b');
+        REQUIRE(tokenize_streaming(long_input, 100u, 64u) == tokenize_whole(long_input));
+        REQUIRE(tokenize_streaming(long_input, 7u, 3u) == tokenize_whole(long_input));
+    }
+}
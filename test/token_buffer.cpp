@@ -0,0 +1,74 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/token_buffer.hpp>
+
+#include <doctest.h>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct token_a, struct token_bc, struct whitespace>;
+
+struct token_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct token_bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+struct whitespace : FOONATHAN_LEX_LITERAL(" "), lex::whitespace_token
+{};
+} // namespace
+
+TEST_CASE("token_buffer")
+{
+    static_assert(sizeof(lex::token_buffer<test_spec>::kind_id) == 1, "");
+
+    lex::token_buffer<test_spec> buffer;
+    REQUIRE(buffer.empty());
+
+    // small capacity, so it has to grow while tokenizing
+    buffer.reserve(2);
+
+    const char array[] = "abc  a!bc";
+    lex::tokenize_all(array, array + sizeof(array) - 1, buffer);
+    REQUIRE(buffer.begin_ptr() == array);
+    REQUIRE(buffer.size() == 5);
+
+    auto verify = [&](std::size_t i, lex::token_kind<test_spec> kind, std::uint32_t offset,
+                      std::uint32_t length) {
+        REQUIRE(buffer.kind(i) == kind);
+        REQUIRE(buffer.kind_ids()[i] == kind.get());
+        REQUIRE(buffer.offset(i) == offset);
+        REQUIRE(buffer.offsets()[i] == offset);
+        REQUIRE(buffer.length(i) == length);
+        REQUIRE(buffer.lengths()[i] == length);
+
+        auto token = buffer[i];
+        REQUIRE(token.kind() == kind);
+        REQUIRE(token.spelling().data() == array + offset);
+        REQUIRE(token.spelling().size() == length);
+    };
+    verify(0, token_a{}, 0, 1);
+    verify(1, token_bc{}, 1, 2);
+    verify(2, token_a{}, 5, 1);
+    verify(3, lex::error_token{}, 6, 1);
+    verify(4, token_bc{}, 7, 2);
+
+    SUBCASE("refill")
+    {
+        const char other[] = " bc";
+        lex::tokenize_all(other, other + sizeof(other) - 1, buffer);
+        REQUIRE(buffer.begin_ptr() == other);
+        REQUIRE(buffer.size() == 1);
+        REQUIRE(buffer.kind(0) == token_bc{});
+        REQUIRE(buffer.offset(0) == 1);
+    }
+    SUBCASE("empty")
+    {
+        lex::tokenize_all(array, array, buffer);
+        REQUIRE(buffer.empty());
+    }
+}
@@ -0,0 +1,102 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/token_generator.hpp>
+
+#if FOONATHAN_LEX_HAS_COROUTINES
+
+#    include <cstring>
+#    include <doctest.h>
+#    include <vector>
+
+#    include <foonathan/lex/tokenizer.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct token_a, struct token_bc, struct whitespace>;
+
+struct token_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct token_bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+struct whitespace : FOONATHAN_LEX_LITERAL(" "), lex::whitespace_token
+{};
+
+// yields the tokens of the input twice, followed by an input without tokens
+lex::token_generator<lex::tokenizer<test_spec>> tokenize_twice(const char* input)
+{
+    for (auto i = 0; i != 2; ++i)
+    {
+        lex::tokenizer<test_spec> tokenizer(input, std::strlen(input));
+        co_yield tokenizer;
+        REQUIRE(tokenizer.is_done());
+    }
+
+    co_yield lex::tokenizer<test_spec>("");
+}
+
+// a stage of a pipeline that only forwards the errors
+lex::generator<lex::token<test_spec>> errors(lex::generator<lex::token<test_spec>> tokens)
+{
+    for (auto token : tokens)
+        if (token.is(lex::error_token{}))
+            co_yield token;
+}
+} // namespace
+
+TEST_CASE("token_generator")
+{
+    const char array[] = "a bc a! bc?";
+
+    SUBCASE("all tokens")
+    {
+        std::vector<lex::token<test_spec>> tokens;
+        for (auto token : lex::generate_tokens(lex::tokenizer<test_spec>(array)))
+            tokens.push_back(token);
+
+        REQUIRE(tokens.size() == 6u);
+        REQUIRE(tokens[0].is(token_a{}));
+        REQUIRE(tokens[1].is(token_bc{}));
+        REQUIRE(tokens[2].is(token_a{}));
+        REQUIRE(tokens[3].spelling() == "!");
+        REQUIRE(tokens[4].is(token_bc{}));
+        REQUIRE(tokens[5].spelling() == "?");
+    }
+    SUBCASE("pipeline")
+    {
+        auto count = 0;
+        for (auto token : errors(lex::generate_tokens(lex::tokenizer<test_spec>(array))))
+        {
+            REQUIRE(token.is(lex::error_token{}));
+            ++count;
+        }
+        REQUIRE(count == 2);
+    }
+    SUBCASE("multiple tokenizers")
+    {
+        const std::size_t offsets[] = {0, 2, 5, 6, 8, 10};
+
+        auto count = 0u;
+        for (auto token : tokenize_twice(array))
+        {
+            REQUIRE(token.spelling().data() == array + offsets[count % 6u]);
+            ++count;
+        }
+        REQUIRE(count == 12u);
+    }
+    SUBCASE("empty")
+    {
+        auto tokens = lex::generate_tokens(lex::tokenizer<test_spec>(""));
+        REQUIRE(tokens.begin() == tokens.end());
+
+        auto empty = tokenize_twice("");
+        REQUIRE(empty.begin() == empty.end());
+    }
+}
+
+#endif
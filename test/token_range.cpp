@@ -0,0 +1,72 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/token_range.hpp>
+
+#include <algorithm>
+#include <doctest.h>
+#include <vector>
+
+#include <foonathan/lex/lookahead_tokenizer.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct token_a, struct token_bc, struct whitespace>;
+
+struct token_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct token_bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+struct whitespace : FOONATHAN_LEX_LITERAL(" "), lex::whitespace_token
+{};
+} // namespace
+
+TEST_CASE("token_range")
+{
+    const char                array[] = "a bc a! bc";
+    lex::tokenizer<test_spec> tokenizer(array);
+
+    SUBCASE("range for")
+    {
+        std::vector<lex::token<test_spec>> tokens;
+        for (auto token : lex::make_token_range(tokenizer))
+            tokens.push_back(token);
+        REQUIRE(tokenizer.is_done());
+
+        REQUIRE(tokens.size() == 5u);
+        REQUIRE(tokens[0].is(token_a{}));
+        REQUIRE(tokens[1].is(token_bc{}));
+        REQUIRE(tokens[2].is(token_a{}));
+        REQUIRE(tokens[3].is(lex::error_token{}));
+        REQUIRE(tokens[4].spelling().data() == array + 8);
+    }
+    SUBCASE("algorithms")
+    {
+        auto range = lex::make_token_range(tokenizer);
+        auto iter  = std::find_if(range.begin(), range.end(), [](lex::token<test_spec> token) {
+            return token.is(lex::error_token{});
+        });
+        REQUIRE(iter != range.end());
+        REQUIRE((*iter).spelling() == "!");
+        REQUIRE((*iter++).is(lex::error_token{}));
+        REQUIRE(tokenizer.peek().is(token_bc{}));
+
+        // the range continues where the tokenizer is
+        REQUIRE(std::distance(range.begin(), range.end()) == 1);
+        REQUIRE(range.begin() == range.end());
+    }
+    SUBCASE("other tokenizers")
+    {
+        lex::lookahead_tokenizer<test_spec, 2u> lookahead(array);
+        auto range = lex::make_token_range(lookahead);
+        REQUIRE(std::count_if(range.begin(), range.end(), [](lex::token<test_spec> token) {
+                    return token.is(token_a{});
+                })
+                == 2);
+    }
+}
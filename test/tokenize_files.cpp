@@ -0,0 +1,133 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/tokenize_files.hpp>
+
+#include <doctest.h>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+using test_spec = lex::token_spec<struct comment, struct slash, struct number, struct whitespace>;
+
+struct slash : FOONATHAN_LEX_LITERAL("/")
+{};
+
+struct comment : lex::rule_token<comment, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r("/*") + lex::token_rule::until("*/");
+    }
+
+    static constexpr bool is_conflicting_literal(lex::token_kind<test_spec> kind) noexcept
+    {
+        return kind == slash{};
+    }
+};
+
+struct number : lex::rule_token<number, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_digit);
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+// kind, offset and length of all tokens
+std::vector<std::uint32_t> flatten(const lex::token_buffer<test_spec>& buffer)
+{
+    std::vector<std::uint32_t> result;
+    for (auto i = 0u; i != buffer.size(); ++i)
+    {
+        result.push_back(buffer.kind_ids()[i]);
+        result.push_back(buffer.offset(i));
+        result.push_back(buffer.length(i));
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("tokenize_files")
+{
+    std::vector<std::string> inputs;
+    SUBCASE("small")
+    {
+        for (auto i = 0; i != 1000; ++i)
+            inputs.push_back(std::to_string(i) + " / " + std::to_string(i * i) + "\n");
+        inputs.emplace_back();
+    }
+    SUBCASE("mixed")
+    {
+        for (auto i = 0; i != 20; ++i)
+        {
+            std::string input;
+            auto        size = i % 4 == 0 ? 2 * 1024 * 1024u : 1024u * unsigned(i);
+            for (auto j = 0; input.size() < size; ++j)
+                input += std::to_string(j) + (j % 100 == 0 ? " /* \n 1 \n */ " : " / ") + "\n";
+            inputs.push_back(std::move(input));
+        }
+    }
+    SUBCASE("long comments")
+    {
+        for (auto i = 0; i != 3; ++i)
+        {
+            std::string input = "1 /*";
+            for (auto j = 0; input.size() < 1024 * 1024u; ++j)
+                input += "\n2 3" + std::string(j % 2 == 0 && j % 10000 == 0 ? "*/" : "");
+            inputs.push_back(std::move(input));
+        }
+    }
+
+    std::vector<std::vector<std::uint32_t>> expected;
+    auto                                    bytes  = std::size_t(0);
+    auto                                    tokens = std::size_t(0);
+    for (auto& input : inputs)
+    {
+        lex::token_buffer<test_spec> buffer;
+        lex::tokenize_all(input.data(), input.data() + input.size(), buffer);
+        expected.push_back(flatten(buffer));
+        bytes += input.size();
+        tokens += buffer.size();
+    }
+
+    for (auto thread_count : {0u, 1u, 2u, 3u, 8u})
+    {
+        INFO(thread_count);
+
+        // every input is passed to the callback exactly once, on some thread
+        std::vector<std::vector<std::uint32_t>> results(inputs.size());
+        std::vector<int>                        calls(inputs.size());
+        auto                                    stats = lex::tokenize_files<test_spec>(
+            inputs.data(), inputs.size(),
+            [&](std::size_t i, const lex::token_buffer<test_spec>& buffer) {
+                ++calls[i];
+                results[i] = flatten(buffer);
+                if (buffer.begin_ptr() != inputs[i].data())
+                    results[i].clear();
+            },
+            thread_count);
+
+        REQUIRE(stats.files == inputs.size());
+        REQUIRE(stats.bytes == bytes);
+        REQUIRE(stats.tokens == tokens);
+        for (auto i = 0u; i != inputs.size(); ++i)
+        {
+            REQUIRE(calls[i] == 1);
+            REQUIRE(results[i] == expected[i]);
+        }
+    }
+}
@@ -2,9 +2,11 @@
 // This file is subject to the license terms in the LICENSE file
 // found in the top-level directory of this distribution.
 
+#include <foonathan/lex/ascii.hpp>
 #include <foonathan/lex/tokenizer.hpp>
 
 #include <doctest.h>
+#include <string>
 
 namespace lex = foonathan::lex;
 
@@ -61,3 +63,164 @@ TEST_CASE("tokenizer")
     tokenizer.bump();
     verify<lex::eof_token>(tokenizer, array + 8, true);
 }
+
+namespace
+{
+struct coalescing_spec : lex::token_spec<struct coalescing_a, struct coalescing_bc,
+                                         struct coalescing_whitespace>
+{
+    static constexpr bool coalesce_errors = true;
+};
+
+struct coalescing_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct coalescing_bc : FOONATHAN_LEX_LITERAL("bc")
+{};
+
+struct coalescing_whitespace : lex::rule_token<coalescing_whitespace, coalescing_spec>,
+                               lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::star(' ');
+    }
+};
+
+template <class Token>
+void verify_get(lex::tokenizer<coalescing_spec>& tokenizer, const char* spelling)
+{
+    auto token = tokenizer.get();
+    REQUIRE(token.is(Token{}));
+    REQUIRE(token.spelling() == spelling);
+}
+} // namespace
+
+TEST_CASE("tokenizer coalesce_errors")
+{
+    lex::tokenizer<coalescing_spec> tokenizer("a@@#bc!!  a\xFF\xFE"
+                                              "bc~~b~");
+    verify_get<coalescing_a>(tokenizer, "a");
+    verify_get<lex::error_token>(tokenizer, "@@#");
+    verify_get<coalescing_bc>(tokenizer, "bc");
+    verify_get<lex::error_token>(tokenizer, "!!");
+    verify_get<coalescing_a>(tokenizer, "a");
+    verify_get<lex::error_token>(tokenizer, "\xFF\xFE");
+    verify_get<coalescing_bc>(tokenizer, "bc");
+    // b can start a token, so the run ends before it
+    verify_get<lex::error_token>(tokenizer, "~~");
+    verify_get<lex::error_token>(tokenizer, "b~");
+    REQUIRE(tokenizer.is_done());
+}
+
+namespace
+{
+template <bool NullTerminated>
+struct sentinel_number;
+template <bool NullTerminated>
+struct sentinel_string;
+template <bool NullTerminated>
+struct sentinel_end;
+template <bool NullTerminated>
+struct sentinel_whitespace;
+
+template <bool NullTerminated>
+struct sentinel_spec
+: lex::token_spec<struct sentinel_abc, struct sentinel_a, struct sentinel_equal,
+                  sentinel_number<NullTerminated>, sentinel_string<NullTerminated>,
+                  sentinel_end<NullTerminated>, sentinel_whitespace<NullTerminated>>
+{
+    static constexpr bool null_terminated = NullTerminated;
+};
+
+struct sentinel_abc : FOONATHAN_LEX_LITERAL("abc")
+{};
+
+struct sentinel_a : FOONATHAN_LEX_LITERAL("a")
+{};
+
+struct sentinel_equal : FOONATHAN_LEX_LITERAL("==")
+{};
+
+template <bool NullTerminated>
+struct sentinel_number
+: lex::rule_token<sentinel_number<NullTerminated>, sentinel_spec<NullTerminated>>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_digit);
+    }
+};
+
+template <bool NullTerminated>
+struct sentinel_string
+: lex::rule_token<sentinel_string<NullTerminated>, sentinel_spec<NullTerminated>>
+{
+    static constexpr auto rule() noexcept
+    {
+        return '"' + lex::token_rule::until('"');
+    }
+};
+
+template <bool NullTerminated>
+struct sentinel_end : lex::rule_token<sentinel_end<NullTerminated>, sentinel_spec<NullTerminated>>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r("end") + lex::token_rule::eof;
+    }
+};
+
+template <bool NullTerminated>
+struct sentinel_whitespace
+: lex::rule_token<sentinel_whitespace<NullTerminated>, sentinel_spec<NullTerminated>>,
+  lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(' ');
+    }
+};
+
+template <bool NullTerminated>
+std::string tokenize_sentinel(const std::string& input)
+{
+    lex::tokenizer<sentinel_spec<NullTerminated>> tokenizer(input.data(),
+                                                            input.data() + input.size());
+
+    std::string result;
+    while (!tokenizer.is_done())
+    {
+        auto token = tokenizer.get();
+        result += std::to_string(token.kind().get()) + ':';
+        result.append(token.spelling().data(), token.spelling().size());
+        result += '|';
+    }
+    result += std::to_string(tokenizer.current_ptr() - tokenizer.begin_ptr());
+    return result;
+}
+} // namespace
+
+TEST_CASE("tokenizer null_terminated")
+{
+    // std::string is always null terminated
+    auto verify = [](const std::string& input) {
+        INFO(input);
+        REQUIRE(tokenize_sentinel<true>(input) == tokenize_sentinel<false>(input));
+    };
+
+    verify("");
+    verify("abc a 12 abc");
+    verify("aabcabc==a=");
+    verify("\"a b\" \"c\"");
+    verify("12 \"unterminated");
+    verify("end end");
+    verify("a en");
+    verify("ab");
+    verify("a=");
+    verify(std::string("a\0abc\0", 6));
+    verify(std::string("\"\0\"\0", 4));
+    verify(std::string("12\0\0 ==", 7));
+
+    REQUIRE(tokenize_sentinel<true>("abc 12 end") == "1:abc|4:12|6:end|10");
+}
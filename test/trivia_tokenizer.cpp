@@ -0,0 +1,173 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/trivia_tokenizer.hpp>
+
+#include <doctest.h>
+#include <string>
+
+#include <foonathan/lex/ascii.hpp>
+#include <foonathan/lex/lookahead_tokenizer.hpp>
+#include <foonathan/lex/parallel_tokenize.hpp>
+#include <foonathan/lex/retokenize.hpp>
+#include <foonathan/lex/token_buffer.hpp>
+
+namespace lex = foonathan::lex;
+
+namespace
+{
+struct test_spec
+: lex::token_spec<struct slash, struct comment, struct number, struct whitespace>
+{
+    static constexpr bool preserve_trivia = true;
+};
+
+struct slash : FOONATHAN_LEX_LITERAL("/")
+{};
+
+struct comment : lex::rule_token<comment, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::r("/*") + lex::token_rule::until("*/");
+    }
+
+    static constexpr bool is_conflicting_literal(lex::token_kind<test_spec> kind) noexcept
+    {
+        return kind == slash{};
+    }
+};
+
+struct number : lex::rule_token<number, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_digit);
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+std::string to_string(lex::token_spelling spelling)
+{
+    return std::string(spelling.data(), spelling.size());
+}
+
+std::string round_trip(const lex::token_buffer<test_spec>& buffer)
+{
+    std::string result;
+    for (auto i = 0u; i != buffer.size(); ++i)
+        result += to_string(buffer[i].leading_trivia()) + to_string(buffer[i].spelling());
+    return result;
+}
+
+template <class Tokenizer>
+std::string round_trip(Tokenizer tokenizer)
+{
+    std::string result;
+    while (true)
+    {
+        auto token = tokenizer.get();
+        result += to_string(token.leading_trivia());
+        result += to_string(token.spelling());
+        if (token.is(lex::eof_token{}))
+            break;
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("trivia_tokenizer")
+{
+    const char array[] = "  1 /* a */ /23/*b*/\n/ ";
+    auto       end     = array + sizeof(array) - 1;
+
+    SUBCASE("round trip")
+    {
+        REQUIRE(round_trip(lex::tokenizer<test_spec>(array)) == array);
+        REQUIRE(round_trip(lex::lookahead_tokenizer<test_spec, 2u>(array)) == array);
+
+        // except for the trailing whitespace, as the buffer doesn't store the EOF token
+        lex::token_buffer<test_spec> buffer;
+        lex::tokenize_all(array, end, buffer);
+        REQUIRE(round_trip(buffer) == "  1 /* a */ /23/*b*/\n/");
+    }
+    SUBCASE("retokenize")
+    {
+        const char old_input[] = "1 1 1 1";
+        const char new_input[] = "1 1 11 1";
+
+        lex::token_buffer<test_spec> tokens;
+        lex::tokenize_all(old_input, old_input + sizeof(old_input) - 1, tokens);
+
+        // the new tokens start with the second one, whose trivia begins after the first one
+        lex::token_buffer<test_spec> new_tokens;
+        auto splice = lex::retokenize(tokens, new_input, new_input + sizeof(new_input) - 1,
+                                      lex::text_edit{4, 0, 1}, new_tokens, 0);
+        REQUIRE(splice.first == 1u);
+        REQUIRE(new_tokens[0].spelling().data() == new_input + 2);
+        REQUIRE(new_tokens[0].leading_trivia().data() == new_input + 1);
+        REQUIRE(new_tokens[0].leading_trivia() == " ");
+
+        lex::apply_splice(tokens, splice, new_tokens);
+        REQUIRE(round_trip(tokens) == new_input);
+    }
+    SUBCASE("chunks")
+    {
+        // the trivia of the first token begins where the chunk starts
+        lex::token_buffer<test_spec> chunk;
+        lex::detail::tokenize_chunk(array, array + 3, end, end, chunk);
+        REQUIRE(chunk[0].is(slash{}));
+        REQUIRE(chunk[0].leading_trivia().data() == array + 3);
+        REQUIRE(chunk[0].leading_trivia().size() == 9u);
+
+        std::string input;
+        while (input.size() < 4 * lex::detail::min_parallel_chunk_size)
+            input += array;
+
+        lex::token_buffer<test_spec> buffer;
+        lex::tokenize_all(input.data(), input.data() + input.size(), buffer, 4);
+        REQUIRE(round_trip(buffer) == input.substr(0, input.size() - 1u));
+    }
+    SUBCASE("walk trivia")
+    {
+        lex::tokenizer<test_spec> tokenizer(array);
+        REQUIRE(tokenizer.get().leading_trivia() == "  ");
+
+        auto token = tokenizer.get();
+        REQUIRE(token.is(slash{}));
+        REQUIRE(token.leading_trivia().data() == array + 3);
+        REQUIRE(token.leading_trivia().size() == 9u);
+
+        lex::trivia_tokenizer<test_spec> trivia(token, end);
+        REQUIRE(!trivia.is_done());
+        REQUIRE(trivia.get().is(whitespace{}));
+        REQUIRE(trivia.peek().is(comment{}));
+        REQUIRE(trivia.get().spelling() == "/* a */");
+        REQUIRE(trivia.get().is(whitespace{}));
+        REQUIRE(trivia.is_done());
+        REQUIRE(trivia.peek().spelling().data() == token.spelling().data());
+        trivia.bump();
+        REQUIRE(trivia.is_done());
+
+        // no trivia at all
+        token = tokenizer.get();
+        REQUIRE(token.is(number{}));
+        REQUIRE(lex::trivia_tokenizer<test_spec>(token, end).is_done());
+
+        // trivia before EOF
+        while (!tokenizer.is_done())
+            tokenizer.bump();
+        lex::trivia_tokenizer<test_spec> trailing(tokenizer.peek(), end);
+        REQUIRE(trailing.get().spelling() == " ");
+        REQUIRE(trailing.is_done());
+        REQUIRE(trailing.peek().is(lex::eof_token{}));
+    }
+}
@@ -0,0 +1,195 @@
+// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <foonathan/lex/unicode.hpp>
+
+#include "tokenize.hpp"
+#include <doctest.h>
+#include <string>
+
+TEST_CASE("unicode predicates")
+{
+    using namespace foonathan::lex::unicode;
+
+    SUBCASE("ASCII")
+    {
+        for (auto c = 0; c <= 0x7F; ++c)
+        {
+            INFO(c);
+            auto cp = static_cast<char32_t>(c);
+            REQUIRE(is_ascii(cp));
+            REQUIRE(is_xid_start(cp) == lex::ascii::is_alpha(char(c)));
+            REQUIRE(is_xid_continue(cp) == (lex::ascii::is_alnum(char(c)) || c == '_'));
+        }
+    }
+    SUBCASE("non-ASCII")
+    {
+        REQUIRE(!is_ascii(0x80));
+
+        // letters
+        REQUIRE(is_xid_start(0xE9));    // é
+        REQUIRE(is_xid_start(0x3B1));   // α
+        REQUIRE(is_xid_start(0x4E00));  // 一
+        REQUIRE(is_xid_start(0x20000)); // CJK extension B
+        REQUIRE(is_xid_continue(0xE9));
+        REQUIRE(is_xid_continue(0x4E00));
+
+        // only continue
+        REQUIRE(!is_xid_start(0xB7)); // middle dot
+        REQUIRE(is_xid_continue(0xB7));
+        REQUIRE(!is_xid_start(0x660)); // arabic-indic digit zero
+        REQUIRE(is_xid_continue(0x660));
+        REQUIRE(!is_xid_start(0x301)); // combining acute accent
+        REQUIRE(is_xid_continue(0x301));
+        REQUIRE(!is_xid_start(0xE0100)); // variation selector
+        REQUIRE(is_xid_continue(0xE0100));
+
+        // neither
+        REQUIRE(!is_xid_start(0xA0)); // no-break space
+        REQUIRE(!is_xid_continue(0xA0));
+        REQUIRE(!is_xid_start(0x2E2F)); // vertical tilde
+        REQUIRE(!is_xid_continue(0x2E2F));
+        REQUIRE(!is_xid_start(0x1F600)); // emoji
+        REQUIRE(!is_xid_continue(0x1F600));
+        REQUIRE(!is_xid_continue(0xE01F0));
+        REQUIRE(!is_xid_continue(0x10FFFF));
+    }
+    SUBCASE("constexpr")
+    {
+        static_assert(is_xid_start(0x4E00), "");
+        static_assert(!is_xid_start(0xB7) && is_xid_continue(0xB7), "");
+    }
+}
+
+TEST_CASE("unicode::decode_utf8")
+{
+    using namespace foonathan::lex::unicode;
+
+    auto decode = [](const char* str) {
+        return decode_utf8(str, str + std::char_traits<char>::length(str));
+    };
+    auto verify = [&](const char* str, char32_t cp, std::size_t length) {
+        auto result = decode(str);
+        return result.length == length && (length == 0u || result.code_point == cp);
+    };
+
+    SUBCASE("well-formed")
+    {
+        REQUIRE(verify("a", 'a', 1));
+        REQUIRE(verify("\xC3\xA9", 0xE9, 2));
+        REQUIRE(verify("\xE4\xB8\x80", 0x4E00, 3));
+        REQUIRE(verify("\xF0\x9F\x98\x80", 0x1F600, 4));
+        REQUIRE(verify("\xF4\x8F\xBF\xBF", 0x10FFFF, 4));
+        REQUIRE(verify("\xC3\xA9\xC3\xA9", 0xE9, 2));
+    }
+    SUBCASE("ill-formed")
+    {
+        REQUIRE(verify("", 0, 0));
+        REQUIRE(verify("\x80", 0, 0));             // continuation byte
+        REQUIRE(verify("\xFF", 0, 0));             // invalid byte
+        REQUIRE(verify("\xC3", 0, 0));             // truncated
+        REQUIRE(verify("\xE4\xB8", 0, 0));         // truncated
+        REQUIRE(verify("\xC3\x41", 0, 0));         // missing continuation
+        REQUIRE(verify("\xC0\x80", 0, 0));         // overlong
+        REQUIRE(verify("\xE0\x80\x80", 0, 0));     // overlong
+        REQUIRE(verify("\xED\xA0\x80", 0, 0));     // surrogate
+        REQUIRE(verify("\xF4\x90\x80\x80", 0, 0)); // too big
+    }
+    SUBCASE("constexpr")
+    {
+        static constexpr const char str[] = "\xE4\xB8\x80";
+        constexpr auto              result = decode_utf8(str, str + 3);
+        static_assert(result.code_point == 0x4E00 && result.length == 3, "");
+    }
+}
+
+namespace
+{
+using test_spec = lex::token_spec<struct identifier, struct whitespace>;
+
+struct identifier : lex::rule_token<identifier, test_spec>
+{
+    static constexpr auto rule() noexcept
+    {
+        using namespace lex::token_rule;
+        return (r('_') / code_point(lex::unicode::is_xid_start))
+               + star(code_point(lex::unicode::is_xid_continue));
+    }
+};
+
+struct whitespace : lex::rule_token<whitespace, test_spec>, lex::whitespace_token
+{
+    static constexpr auto rule() noexcept
+    {
+        return lex::token_rule::plus(lex::ascii::is_space);
+    }
+};
+
+std::vector<std::string> tokenize_identifiers(const std::string& input)
+{
+    std::vector<std::string> result;
+
+    lex::tokenizer<test_spec> tokenizer(input.data(), input.size());
+    while (!tokenizer.is_done())
+    {
+        auto token = tokenizer.get();
+        if (token.is(identifier{}))
+            result.emplace_back(token.spelling().data(), token.spelling().size());
+        else
+            result.push_back("<error>");
+    }
+
+    return result;
+}
+} // namespace
+
+TEST_CASE("token_rule::code_point")
+{
+    SUBCASE("basic")
+    {
+        auto result = tokenize_identifiers("x gr\xC3\xB6\xC3\x9F" "e \xE5\xA4\x89\xE6\x95\xB0 _a1");
+        REQUIRE(result
+                == std::vector<std::string>{"x", "gr\xC3\xB6\xC3\x9F"
+                                                 "e",
+                                            "\xE5\xA4\x89\xE6\x95\xB0", "_a1"});
+    }
+    SUBCASE("invalid start")
+    {
+        // the error consumes one byte at a time
+        auto result = tokenize_identifiers("\xC2\xB7x 1");
+        REQUIRE(result == std::vector<std::string>{"<error>", "<error>", "x", "<error>"});
+    }
+    SUBCASE("ill-formed continue")
+    {
+        auto result = tokenize_identifiers("ab\xFF");
+        REQUIRE(result == std::vector<std::string>{"ab", "<error>"});
+    }
+    SUBCASE("long identifiers")
+    {
+        // long enough to be skipped in blocks
+        std::string ascii(100, 'a');
+        ascii += "_0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+        std::string mixed = ascii + "\xC3\xA9" + ascii + "\xC2\xB7" + ascii;
+
+        for (auto& end : {std::string(""), std::string(" "), std::string("\xFF"),
+                          std::string(" ") + std::string(40, ' '), std::string("@"),
+                          std::string("\xC2\xA0")})
+        {
+            INFO(end);
+            REQUIRE(tokenize_identifiers(ascii + end)[0] == ascii);
+            REQUIRE(tokenize_identifiers(mixed + end)[0] == mixed);
+        }
+    }
+    SUBCASE("constexpr")
+    {
+        static constexpr const char       array[]   = "gr\xC3\xB6\xC3\x9F" "e a";
+        constexpr auto                    tokenizer = lex::tokenizer<test_spec>(array);
+        FOONATHAN_LEX_TEST_CONSTEXPR auto result    = tokenize<test_spec>(tokenizer);
+
+        REQUIRE(result.size() == 2);
+        REQUIRE(result[0].is(identifier{}));
+        REQUIRE(result[0].spelling().size() == 7);
+        REQUIRE(result[1].is(identifier{}));
+    }
+}
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+# Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+# This file is subject to the license terms in the LICENSE file
+# found in the top-level directory of this distribution.
+
+"""Generates include/foonathan/lex/detail/unicode_tables.hpp.
+
+Usage: generate_unicode_tables.py [DerivedCoreProperties.txt] > unicode_tables.hpp
+
+The XID_Start and XID_Continue properties are read from the given
+DerivedCoreProperties.txt of the Unicode Character Database,
+e.g. https://www.unicode.org/Public/14.0.0/ucd/DerivedCoreProperties.txt.
+Without an argument, they are taken from the Unicode data of the Python interpreter.
+"""
+
+import re
+import sys
+import unicodedata
+
+# must match `xid_table_limit` in the generated header
+TABLE_LIMIT = 0x40000
+BLOCK_SIZE = 256
+# the XID_Continue code points above the limit, handled explicitly in unicode.hpp
+CONTINUE_ABOVE_LIMIT = range(0xE0100, 0xE01EF + 1)
+
+
+def read_properties(path):
+    start, cont = set(), set()
+    version = None
+    pattern = re.compile(r'^([0-9A-F]+)(?:\.\.([0-9A-F]+))?\s*;\s*(XID_Start|XID_Continue)\b')
+    with open(path, encoding='utf-8') as file:
+        for line in file:
+            if version is None:
+                match = re.match(r'^# DerivedCoreProperties-(\d+\.\d+\.\d+)\.txt', line)
+                if match:
+                    version = match.group(1)
+            match = pattern.match(line)
+            if not match:
+                continue
+            first = int(match.group(1), 16)
+            last = int(match.group(2), 16) if match.group(2) else first
+            target = start if match.group(3) == 'XID_Start' else cont
+            target.update(range(first, last + 1))
+    return version, start, cont
+
+
+def python_properties():
+    start, cont = set(), set()
+    for cp in range(0x110000):
+        if 0xD800 <= cp <= 0xDFFF:
+            continue
+        char = chr(cp)
+        # `isidentifier()` checks XID_Start for the first character, except for the underscore,
+        # and XID_Continue for the others
+        if char.isidentifier() and char != '_':
+            start.add(cp)
+        if ('a' + char).isidentifier():
+            cont.add(cp)
+    return unicodedata.unidata_version, start, cont
+
+
+def block_words(properties, block):
+    words = []
+    for word in range(BLOCK_SIZE // 32):
+        value = 0
+        for bit in range(32):
+            if block * BLOCK_SIZE + word * 32 + bit in properties:
+                value |= 1 << bit
+        words.append(value)
+    return tuple(words)
+
+
+def format_array(type_name, name, values, per_line, formatter):
+    lines = ['                static constexpr {} {}[{}] = {{'.format(type_name, name, len(values))]
+    for i in range(0, len(values), per_line):
+        chunk = values[i:i + per_line]
+        lines.append('                    ' + ' '.join(formatter(v) + ',' for v in chunk))
+    lines.append('                };')
+    return '\n'.join(lines)
+
+
+def main():
+    if len(sys.argv) > 1:
+        version, start, cont = read_properties(sys.argv[1])
+    else:
+        version, start, cont = python_properties()
+
+    above_start = [cp for cp in start if cp >= TABLE_LIMIT]
+    above_cont = sorted(cp for cp in cont if cp >= TABLE_LIMIT)
+    if above_start or above_cont != list(CONTINUE_ABOVE_LIMIT):
+        sys.exit('code points above the table limit changed, update unicode.hpp')
+
+    # each block of code points is stored as a pair of bitsets, identical pairs are shared
+    stage1, start_words, cont_words = [], [], []
+    blocks = {}
+    for block in range(TABLE_LIMIT // BLOCK_SIZE):
+        key = (block_words(start, block), block_words(cont, block))
+        if key not in blocks:
+            blocks[key] = len(blocks)
+            start_words.extend(key[0])
+            cont_words.extend(key[1])
+        stage1.append(blocks[key])
+    if len(blocks) > 256:
+        sys.exit('too many distinct blocks for an 8 bit index')
+
+    print('''// Copyright (C) 2018-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef FOONATHAN_LEX_DETAIL_UNICODE_TABLES_HPP_INCLUDED
+#define FOONATHAN_LEX_DETAIL_UNICODE_TABLES_HPP_INCLUDED
+
+#include <cstdint>
+
+// generated from the XID_Start and XID_Continue properties of Unicode {version},
+// do not edit manually, use tools/generate_unicode_tables.py instead
+
+namespace foonathan
+{{
+namespace lex
+{{
+    namespace unicode
+    {{
+        namespace detail
+        {{
+            // the tables only cover the code points below `xid_table_limit`,
+            // all code points above are neither XID_Start nor XID_Continue,
+            // except for the variation selectors U+E0100 to U+E01EF which are XID_Continue
+            constexpr char32_t xid_table_limit = 0x{limit:X};
+
+            // `stage1[cp >> 8]` is the index of the block of the code point,
+            // the block stores one bit per code point in eight 32 bit words
+            template <typename = void>
+            struct xid_tables
+            {{'''.format(version=version, limit=TABLE_LIMIT))
+    print(format_array('std::uint8_t', 'stage1', stage1, 16, str))
+    print(format_array('std::uint32_t', 'start', start_words, 6, '0x{:08X}'.format))
+    print(format_array('std::uint32_t', 'continue_', cont_words, 6, '0x{:08X}'.format))
+    print('''            };
+
+            template <typename T>
+            constexpr std::uint8_t xid_tables<T>::stage1[];
+            template <typename T>
+            constexpr std::uint32_t xid_tables<T>::start[];
+            template <typename T>
+            constexpr std::uint32_t xid_tables<T>::continue_[];
+        } // namespace detail
+    } // namespace unicode
+} // namespace lex
+} // namespace foonathan
+
+#endif // FOONATHAN_LEX_DETAIL_UNICODE_TABLES_HPP_INCLUDED''')
+
+
+if __name__ == '__main__':
+    main()